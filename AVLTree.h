@@ -4,44 +4,116 @@
 
 #include <iostream>
 #include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
 #include "GroceryItem.h"
+#include "NodePool.h"
+#include "CatalogIndex.h"
+
+// Outcome of taking stock out of (or putting it back into) an inventory.
+enum class StockStatus {
+    Ok,
+    NotFound,
+    InsufficientStock,
+    InvalidQuantity
+};
+
+// Told about every change made through AVLTree's own operations, after the
+// change is made; bulk loads (assignSorted) are not reported. InventoryLog
+// listens to write the inventory's write-ahead log.
+class InventoryListener {
+public:
+    virtual ~InventoryListener() = default;
+    virtual void onInsert(const GroceryItem& item) = 0;
+    virtual void onUpdate(UpcKey upc, const GroceryItem& item) = 0;
+    virtual void onRemove(UpcKey upc) = 0;
+    virtual void onStockChange(UpcKey upc, int delta) = 0;
+};
 
 class AVLTree {
 private:
+    // Nodes link to each other by 32-bit slot index. A node is split over
+    // two NodePools that hand out the same slots in lockstep: the part a
+    // search walks (key and children, 16 bytes, four to a cache line) and
+    // the item and height, touched only on a hit or while rebalancing.
     struct Node {
+        UpcKey key;
+        uint32_t left;
+        uint32_t right;
+        
+        Node() : left(nil), right(nil) {}
+    };
+    
+    struct Entry {
         GroceryItem item;
-        Node* left;
-        Node* right;
         int height;
         
-        Node(const GroceryItem& i) : item(i), left(nullptr), right(nullptr), height(1) {}
+        Entry() : height(1) {}
     };
     
-    Node* root;
+    static constexpr uint32_t nil = NodePool<Node>::npos;
+    
+    NodePool<Node> pool;
+    NodePool<Entry> entries; // same slot as the node
+    uint32_t root;
+    std::unique_ptr<CatalogIndex> indexes; // aisle and name lookups, when enabled
+    InventoryListener* listener;
+    
+    Node& at(uint32_t node) { return pool[node]; }
+    const Node& at(uint32_t node) const { return pool[node]; }
+    GroceryItem& itemAt(uint32_t node) { return entries[node].item; }
+    const GroceryItem& itemAt(uint32_t node) const { return entries[node].item; }
+    
+    // A slot in both pools; they allocate and release together, so the
+    // index comes out the same
+    uint32_t allocateNode() {
+        uint32_t node = pool.allocate();
+        entries.allocate();
+        return node;
+    }
+    
+    uint32_t newNode(const GroceryItem& item) {
+        uint32_t node = allocateNode();
+        Node& n = at(node);
+        n.key = item.getUpc();
+        n.left = nil;
+        n.right = nil;
+        entries[node].item = item;
+        entries[node].height = 1;
+        return node;
+    }
+    
+    void freeNode(uint32_t node) {
+        itemAt(node) = GroceryItem();
+        pool.release(node);
+        entries.release(node);
+    }
     
     // Helper functions
-    int height(Node* node) {
-        if (node == nullptr) return 0;
-        return node->height;
+    int height(uint32_t node) const {
+        if (node == nil) return 0;
+        return entries[node].height;
     }
     
-    int balanceFactor(Node* node) {
-        if (node == nullptr) return 0;
-        return height(node->left) - height(node->right);
+    int balanceFactor(uint32_t node) const {
+        if (node == nil) return 0;
+        return height(at(node).left) - height(at(node).right);
     }
     
-    void updateHeight(Node* node) {
-        if (node == nullptr) return;
-        node->height = 1 + std::max(height(node->left), height(node->right));
+    void updateHeight(uint32_t node) {
+        if (node == nil) return;
+        entries[node].height = 1 + std::max(height(at(node).left), height(at(node).right));
     }
     
-    Node* rightRotate(Node* y) {
-        Node* x = y->left;
-        Node* T2 = x->right;
+    uint32_t rightRotate(uint32_t y) {
+        uint32_t x = at(y).left;
+        uint32_t T2 = at(x).right;
         
         // Perform rotation
-        x->right = y;
-        y->left = T2;
+        at(x).right = y;
+        at(y).left = T2;
         
         // Update heights
         updateHeight(y);
@@ -50,13 +122,13 @@ private:
         return x;
     }
     
-    Node* leftRotate(Node* x) {
-        Node* y = x->right;
-        Node* T2 = y->left;
+    uint32_t leftRotate(uint32_t x) {
+        uint32_t y = at(x).right;
+        uint32_t T2 = at(y).left;
         
         // Perform rotation
-        y->left = x;
-        x->right = T2;
+        at(y).left = x;
+        at(x).right = T2;
         
         // Update heights
         updateHeight(x);
@@ -65,15 +137,15 @@ private:
         return y;
     }
     
-    Node* insertNode(Node* node, const GroceryItem& item) {
+    uint32_t insertNode(uint32_t node, const GroceryItem& item) {
         // Standard BST insertion
-        if (node == nullptr)
-            return new Node(item);
+        if (node == nil)
+            return newNode(item);
             
-        if (item.getUpcCode() < node->item.getUpcCode())
-            node->left = insertNode(node->left, item);
-        else if (item.getUpcCode() > node->item.getUpcCode())
-            node->right = insertNode(node->right, item);
+        if (item.getUpc() < at(node).key)
+            at(node).left = insertNode(at(node).left, item);
+        else if (item.getUpc() > at(node).key)
+            at(node).right = insertNode(at(node).right, item);
         else
             return node; // Duplicate UPC codes not allowed
             
@@ -84,64 +156,65 @@ private:
         int balance = balanceFactor(node);
         
         // Left Left Case
-        if (balance > 1 && item.getUpcCode() < node->left->item.getUpcCode())
+        if (balance > 1 && item.getUpc() < at(at(node).left).key)
             return rightRotate(node);
             
         // Right Right Case
-        if (balance < -1 && item.getUpcCode() > node->right->item.getUpcCode())
+        if (balance < -1 && item.getUpc() > at(at(node).right).key)
             return leftRotate(node);
             
         // Left Right Case
-        if (balance > 1 && item.getUpcCode() > node->left->item.getUpcCode()) {
-            node->left = leftRotate(node->left);
+        if (balance > 1 && item.getUpc() > at(at(node).left).key) {
+            at(node).left = leftRotate(at(node).left);
             return rightRotate(node);
         }
         
         // Right Left Case
-        if (balance < -1 && item.getUpcCode() < node->right->item.getUpcCode()) {
-            node->right = rightRotate(node->right);
+        if (balance < -1 && item.getUpc() < at(at(node).right).key) {
+            at(node).right = rightRotate(at(node).right);
             return leftRotate(node);
         }
         
         return node;
     }
     
-    Node* findMinValueNode(Node* node) {
-        Node* current = node;
-        while (current && current->left != nullptr)
-            current = current->left;
+    uint32_t findMinValueNode(uint32_t node) const {
+        uint32_t current = node;
+        while (current != nil && at(current).left != nil)
+            current = at(current).left;
         return current;
     }
     
-    Node* deleteNode(Node* root, const std::string& upcCode) {
+    uint32_t deleteNode(uint32_t root, UpcKey upcCode) {
         // Standard BST delete
-        if (root == nullptr)
+        if (root == nil)
             return root;
             
-        if (upcCode < root->item.getUpcCode())
-            root->left = deleteNode(root->left, upcCode);
-        else if (upcCode > root->item.getUpcCode())
-            root->right = deleteNode(root->right, upcCode);
+        if (upcCode < at(root).key)
+            at(root).left = deleteNode(at(root).left, upcCode);
+        else if (upcCode > at(root).key)
+            at(root).right = deleteNode(at(root).right, upcCode);
         else {
             // Node with only one child or no child
-            if (root->left == nullptr) {
-                Node* temp = root->right;
-                delete root;
+            if (at(root).left == nil) {
+                uint32_t temp = at(root).right;
+                freeNode(root);
                 return temp;
-            } else if (root->right == nullptr) {
-                Node* temp = root->left;
-                delete root;
+            } else if (at(root).right == nil) {
+                uint32_t temp = at(root).left;
+                freeNode(root);
                 return temp;
             }
             
             // Node with two children
-            Node* temp = findMinValueNode(root->right);
-            root->item = temp->item;
-            root->right = deleteNode(root->right, temp->item.getUpcCode());
+            uint32_t temp = findMinValueNode(at(root).right);
+            at(root).key = at(temp).key;
+            itemAt(root) = itemAt(temp);
+            at(root).right = deleteNode(at(root).right, at(temp).key);
         }
         
         // If the tree had only one node
-        if (root == nullptr)
+        if (root == nil)
             return root;
             
         // Update height
@@ -151,101 +224,241 @@ private:
         int balance = balanceFactor(root);
         
         // Left Left Case
-        if (balance > 1 && balanceFactor(root->left) >= 0)
+        if (balance > 1 && balanceFactor(at(root).left) >= 0)
             return rightRotate(root);
             
         // Left Right Case
-        if (balance > 1 && balanceFactor(root->left) < 0) {
-            root->left = leftRotate(root->left);
+        if (balance > 1 && balanceFactor(at(root).left) < 0) {
+            at(root).left = leftRotate(at(root).left);
             return rightRotate(root);
         }
         
         // Right Right Case
-        if (balance < -1 && balanceFactor(root->right) <= 0)
+        if (balance < -1 && balanceFactor(at(root).right) <= 0)
             return leftRotate(root);
             
         // Right Left Case
-        if (balance < -1 && balanceFactor(root->right) > 0) {
-            root->right = rightRotate(root->right);
+        if (balance < -1 && balanceFactor(at(root).right) > 0) {
+            at(root).right = rightRotate(at(root).right);
             return leftRotate(root);
         }
         
         return root;
     }
     
-    Node* searchNode(Node* root, const std::string& upcCode) const {
-        if (root == nullptr || root->item.getUpcCode() == upcCode)
-            return root;
-            
-        if (upcCode < root->item.getUpcCode())
-            return searchNode(root->left, upcCode);
-            
-        return searchNode(root->right, upcCode);
+    // Iterative descent; no recursion needed for a lookup.
+    uint32_t searchNode(uint32_t node, UpcKey upcCode) const {
+        while (node != nil) {
+            const Node& n = at(node);
+            if (upcCode == n.key)
+                return node;
+            node = upcCode < n.key ? n.left : n.right;
+        }
+        return nil;
     }
-    
-    void inOrderTraversal(Node* node) const {
-        if (node == nullptr) return;
-        
-        inOrderTraversal(node->left);
-        std::cout << "UPC: " << node->item.getUpcCode() 
-                  << ", Name: " << node->item.getName() 
-                  << ", Price: $" << node->item.getPrice() 
-                  << ", Quantity: " << node->item.getQuantity()
-                  << ", Aisle: " << node->item.getAisle() << std::endl;
-        inOrderTraversal(node->right);
+
+    // Resolve the sorted keys[lo, hi) below node. Keys smaller than the
+    // node's UPC go left and larger ones go right, so every node is visited
+    // at most once however many keys pass through it. Once one key is left
+    // its paths are not shared, so it takes the plain search loop.
+    void searchRange(uint32_t node, const UpcKey* keys, size_t lo, size_t hi, GroceryItem** found) {
+        while (lo < hi) {
+            if (hi - lo == 1) {
+                node = searchNode(node, keys[lo]);
+                found[lo] = node == nil ? nullptr : &itemAt(node);
+                return;
+            }
+            if (node == nil) {
+                std::fill(found + lo, found + hi, nullptr);
+                return;
+            }
+            Node& n = at(node);
+            UpcKey key = n.key;
+            size_t split = std::lower_bound(keys + lo, keys + hi, key) - keys;
+            size_t after = split;
+            while (after < hi && keys[after] == key) {
+                found[after++] = &itemAt(node);
+            }
+            // Recurse into the smaller side, loop on the other
+            if (split - lo < hi - after) {
+                searchRange(n.left, keys, lo, split, found);
+                node = n.right;
+                lo = after;
+            } else {
+                searchRange(n.right, keys, after, hi, found);
+                node = n.left;
+                hi = split;
+            }
+        }
     }
-    
-    void clearTree(Node* node) {
-        if (node == nullptr) return;
+
+    // Link the nodes ids[lo, hi), already in key order, into a perfectly
+    // balanced subtree: the middle node is the root, and heights come out
+    // right without any rotation.
+    uint32_t linkBalanced(const std::vector<uint32_t>& ids, size_t lo, size_t hi) {
+        if (lo >= hi) return nil;
+        size_t mid = lo + (hi - lo) / 2;
+        uint32_t node = ids[mid];
+        at(node).left = linkBalanced(ids, lo, mid);
+        at(node).right = linkBalanced(ids, mid + 1, hi);
+        updateHeight(node);
+        return node;
+    }
+
+    void inOrderTraversal(uint32_t node) const {
+        if (node == nil) return;
         
-        clearTree(node->left);
-        clearTree(node->right);
-        delete node;
+        const Node& n = at(node);
+        const GroceryItem& item = itemAt(node);
+        inOrderTraversal(n.left);
+        std::cout << "UPC: " << item.getUpc() 
+                  << ", Name: " << item.getName() 
+                  << ", Price: $" << item.getPrice() 
+                  << ", Quantity: " << item.getQuantity()
+                  << ", Aisle: " << item.getAisle() << std::endl;
+        inOrderTraversal(n.right);
     }
 
 public:
-    AVLTree() : root(nullptr) {}
+    AVLTree() : root(nil), listener(nullptr) {}
     
-    ~AVLTree() {
-        clearTree(root);
-    }
+    AVLTree(const AVLTree&) = delete;
+    AVLTree& operator=(const AVLTree&) = delete;
+    
+    // Nodes are released a block at a time when the pools go away.
+    ~AVLTree() = default;
     
     // Create operation - Insert a grocery item
     void insert(const GroceryItem& item) {
+        if (!item.getUpc().isValid()) return; // Items need a parseable UPC
+        size_t before = pool.size();
         root = insertNode(root, item);
+        if (pool.size() == before) return;
+        if (indexes) indexes->add(item);
+        if (listener) listener->onInsert(item);
+    }
+    
+    // Replace the whole inventory with items, which must be sorted by UPC
+    // with valid, distinct keys (CatalogLoader prepares them this way).
+    // The tree is built bottom-up in O(n) with no rotations.
+    void assignSorted(std::vector<GroceryItem>&& items) {
+        clear();
+        pool.reserve(items.size());
+        entries.reserve(items.size());
+        std::vector<uint32_t> ids(items.size());
+        for (size_t i = 0; i < items.size(); ++i) {
+            ids[i] = allocateNode();
+            at(ids[i]).key = items[i].getUpc();
+            itemAt(ids[i]) = std::move(items[i]); // links and height are set below
+        }
+        root = linkBalanced(ids, 0, ids.size());
+        items.clear();
+        if (indexes) rebuildIndexes();
     }
     
     // Read operation - Search for an item by UPC code
+    GroceryItem* search(UpcKey upcCode) {
+        uint32_t result = searchNode(root, upcCode);
+        if (result == nil) {
+            return nullptr;
+        }
+        return &itemAt(result);
+    }
+    
+    const GroceryItem* search(UpcKey upcCode) const {
+        uint32_t result = searchNode(root, upcCode);
+        if (result == nil) {
+            return nullptr;
+        }
+        return &itemAt(result);
+    }
+    
+    // Batch lookup in one walk of the tree. keys[0..count) must be sorted
+    // ascending; found[i] receives the item for keys[i] or nullptr.
+    void searchSorted(const UpcKey* keys, size_t count, GroceryItem** found) {
+        searchRange(root, keys, 0, count, found);
+    }
+
     GroceryItem* search(const std::string& upcCode) {
-        Node* result = searchNode(root, upcCode);
-        if (result == nullptr) {
+        UpcKey key;
+        if (!UpcKey::parse(upcCode, key)) {
             return nullptr;
         }
-        return &(result->item);
+        return search(key);
     }
     
     // Update operation - Update an existing item
-    bool update(const std::string& upcCode, const GroceryItem& newItem) {
-        Node* node = searchNode(root, upcCode);
-        if (node == nullptr) {
+    bool update(UpcKey upcCode, const GroceryItem& newItem) {
+        uint32_t node = searchNode(root, upcCode);
+        if (node == nil) {
             return false;
         }
-        node->item = newItem;
+        GroceryItem& item = itemAt(node);
+        if (indexes) indexes->remove(item);
+        item = newItem;
+        item.setUpc(upcCode); // the key cannot move within the tree
+        if (indexes) indexes->add(item);
+        if (listener) listener->onUpdate(upcCode, newItem);
         return true;
     }
     
+    bool update(const std::string& upcCode, const GroceryItem& newItem) {
+        UpcKey key;
+        return UpcKey::parse(upcCode, key) && update(key, newItem);
+    }
+    
     // Delete operation - Remove an item by UPC code
-    bool remove(const std::string& upcCode) {
-        if (searchNode(root, upcCode) == nullptr) {
+    bool remove(UpcKey upcCode) {
+        uint32_t node = searchNode(root, upcCode);
+        if (node == nil) {
             return false;  // Item not found
         }
+        if (indexes) indexes->remove(itemAt(node));
         root = deleteNode(root, upcCode);
+        if (listener) listener->onRemove(upcCode);
         return true;
     }
     
+    bool remove(const std::string& upcCode) {
+        UpcKey key;
+        return UpcKey::parse(upcCode, key) && remove(key);
+    }
+    
+    // Take quantity units out of stock if that many are on hand
+    StockStatus reserveStock(UpcKey upcCode, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        GroceryItem* item = search(upcCode);
+        if (item == nullptr) return StockStatus::NotFound;
+        if (item->getQuantity() < quantity) return StockStatus::InsufficientStock;
+        adjustStock(*item, -quantity);
+        return StockStatus::Ok;
+    }
+    
+    // Put quantity units back into stock
+    StockStatus releaseStock(UpcKey upcCode, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        GroceryItem* item = search(upcCode);
+        if (item == nullptr) return StockStatus::NotFound;
+        adjustStock(*item, quantity);
+        return StockStatus::Ok;
+    }
+    
+    // Change the stock of an item that search() returned by delta units.
+    // Stock changes made through the pointer directly are not reported to
+    // the listener.
+    void adjustStock(GroceryItem& item, int delta) {
+        item.setQuantity(item.getQuantity() + delta);
+        if (listener) listener->onStockChange(item.getUpc(), delta);
+    }
+    
+    // Report every later change to listener (nullptr to stop)
+    void setListener(InventoryListener* newListener) {
+        listener = newListener;
+    }
+    
     // Display all items in order (by UPC code)
     void displayAllItems() const {
-        if (root == nullptr) {
+        if (root == nil) {
             std::cout << "Inventory is empty." << std::endl;
             return;
         }
@@ -255,9 +468,72 @@ public:
         std::cout << "----------------------------------" << std::endl;
     }
     
+    // Call visit(item) for every item in UPC order
+    template <typename Visitor>
+    void forEachItem(Visitor visit) const {
+        // Explicit stack; the tree height is at most ~1.44 log2(n)
+        uint32_t stack[96];
+        size_t depth = 0;
+        uint32_t node = root;
+        while (node != nil || depth > 0) {
+            while (node != nil) {
+                stack[depth++] = node;
+                node = at(node).left;
+            }
+            node = stack[--depth];
+            visit(itemAt(node));
+            node = at(node).right;
+        }
+    }
+    
     // Check if the tree is empty
     bool isEmpty() const {
-        return root == nullptr;
+        return root == nil;
+    }
+    
+    // Number of items currently stored
+    size_t size() const {
+        return pool.size();
+    }
+    
+    // Drop every item at once; the node blocks are kept for reuse.
+    void clear() {
+        pool.reset();
+        entries.reset();
+        root = nil;
+        if (indexes) indexes->clear();
+    }
+    
+    // Secondary indexes on aisle and name. Once enabled they follow every
+    // insert, update, remove and bulk load. Names and aisles must then be
+    // changed through update(), not through the pointer search() returns.
+    void enableSecondaryIndexes() {
+        if (indexes) return;
+        indexes = std::make_unique<CatalogIndex>();
+        rebuildIndexes();
+    }
+    
+    void rebuildIndexes() {
+        if (!indexes) return;
+        indexes->clear();
+        indexes->reserve(size());
+        forEachItem([this](const GroceryItem& item) { indexes->appendUnsorted(item); });
+        indexes->finishAppending();
+    }
+    
+    bool hasSecondaryIndexes() const { return indexes != nullptr; }
+    
+    // UPCs of the items in an aisle (any case); empty unless indexes are enabled
+    AisleIndex::Range itemsInAisle(std::string_view aisle) const {
+        static const CatalogIndex none;
+        return (indexes ? *indexes : none).inAisle(aisle);
+    }
+    
+    // UPCs of the items whose name starts with prefix (any case), in name
+    // order; empty unless indexes are enabled
+    NamePrefixIndex::Range itemsWithNamePrefix(std::string_view prefix) const {
+        static const CatalogIndex none;
+        return (indexes ? *indexes : none).withNamePrefix(prefix);
     }
 };
 
@@ -0,0 +1,196 @@
+// AggregationKernels.cpp - Scalar and AVX2 implementations of the column reductions
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "AggregationKernels.h"
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define GROCERY_HAVE_AVX2 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+int64_t sumScalar(const int64_t* values, size_t count) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+int64_t sumInTimeRangeScalar(const int64_t* values, const int64_t* times, size_t count,
+                             int64_t from, int64_t to) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (times[i] >= from && times[i] < to) {
+            sum += values[i];
+        }
+    }
+    return sum;
+}
+
+void minMaxScalar(const int64_t* values, size_t count, int64_t& minValue, int64_t& maxValue) {
+    int64_t low = values[0];
+    int64_t high = values[0];
+    for (size_t i = 1; i < count; ++i) {
+        if (values[i] < low) low = values[i];
+        if (values[i] > high) high = values[i];
+    }
+    minValue = low;
+    maxValue = high;
+}
+
+#ifdef GROCERY_HAVE_AVX2
+
+bool cpuHasAvx2() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+// Add up the four lanes of a vector
+__attribute__((target("avx2")))
+inline int64_t foldLanes(__m256i v) {
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), v);
+    return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+__attribute__((target("avx2")))
+inline __m256i load(const int64_t* values) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+}
+
+// Four accumulators (sixteen values per iteration) hide the add latency
+__attribute__((target("avx2")))
+int64_t sumAvx2(const int64_t* values, size_t count) {
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    __m256i acc2 = _mm256_setzero_si256();
+    __m256i acc3 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc0 = _mm256_add_epi64(acc0, load(values + i));
+        acc1 = _mm256_add_epi64(acc1, load(values + i + 4));
+        acc2 = _mm256_add_epi64(acc2, load(values + i + 8));
+        acc3 = _mm256_add_epi64(acc3, load(values + i + 12));
+    }
+    int64_t sum = foldLanes(_mm256_add_epi64(_mm256_add_epi64(acc0, acc1), _mm256_add_epi64(acc2, acc3)));
+    return sum + sumScalar(values + i, count - i);
+}
+
+// All-ones lanes where from <= times[i] < to
+__attribute__((target("avx2")))
+inline __m256i timeMask(const int64_t* times, __m256i from, __m256i to) {
+    __m256i t = load(times);
+    __m256i beforeFrom = _mm256_cmpgt_epi64(from, t); // t < from
+    __m256i beforeTo = _mm256_cmpgt_epi64(to, t);     // t < to
+    return _mm256_andnot_si256(beforeFrom, beforeTo);
+}
+
+// Values are only loaded for blocks with a row in range: a report range
+// is usually a small slice of a time-ordered history, and skipping the
+// rest halves the memory traffic
+__attribute__((target("avx2")))
+int64_t sumInTimeRangeAvx2(const int64_t* values, const int64_t* times, size_t count,
+                           int64_t from, int64_t to) {
+    __m256i lower = _mm256_set1_epi64x(from);
+    __m256i upper = _mm256_set1_epi64x(to);
+    __m256i acc0 = _mm256_setzero_si256();
+    __m256i acc1 = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256i mask0 = timeMask(times + i, lower, upper);
+        __m256i mask1 = timeMask(times + i + 4, lower, upper);
+        if (_mm256_testz_si256(_mm256_or_si256(mask0, mask1), _mm256_set1_epi64x(-1))) continue;
+        acc0 = _mm256_add_epi64(acc0, _mm256_and_si256(mask0, load(values + i)));
+        acc1 = _mm256_add_epi64(acc1, _mm256_and_si256(mask1, load(values + i + 4)));
+    }
+    int64_t sum = foldLanes(_mm256_add_epi64(acc0, acc1));
+    return sum + sumInTimeRangeScalar(values + i, times + i, count - i, from, to);
+}
+
+// AVX2 has no 64-bit min/max instruction; compare and blend instead
+__attribute__((target("avx2")))
+void minMaxAvx2(const int64_t* values, size_t count, int64_t& minValue, int64_t& maxValue) {
+    if (count < 4) {
+        minMaxScalar(values, count, minValue, maxValue);
+        return;
+    }
+    __m256i low = load(values);
+    __m256i high = low;
+    size_t i = 4;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = load(values + i);
+        low = _mm256_blendv_epi8(low, v, _mm256_cmpgt_epi64(low, v));
+        high = _mm256_blendv_epi8(high, v, _mm256_cmpgt_epi64(v, high));
+    }
+    int64_t lows[4];
+    int64_t highs[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lows), low);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(highs), high);
+    int64_t lowest = lows[0];
+    int64_t highest = highs[0];
+    for (size_t l = 1; l < 4; ++l) {
+        if (lows[l] < lowest) lowest = lows[l];
+        if (highs[l] > highest) highest = highs[l];
+    }
+    for (; i < count; ++i) {
+        if (values[i] < lowest) lowest = values[i];
+        if (values[i] > highest) highest = values[i];
+    }
+    minValue = lowest;
+    maxValue = highest;
+}
+
+#else
+
+bool cpuHasAvx2() { return false; }
+
+#endif // GROCERY_HAVE_AVX2
+
+std::atomic<bool> scalarForced(false);
+
+bool avx2Active() {
+    static const bool supported = cpuHasAvx2();
+    return supported && !scalarForced.load(std::memory_order_relaxed);
+}
+
+}
+
+int64_t sumColumn(const int64_t* values, size_t count) {
+#ifdef GROCERY_HAVE_AVX2
+    if (avx2Active()) return sumAvx2(values, count);
+#endif
+    return sumScalar(values, count);
+}
+
+int64_t sumInTimeRange(const int64_t* values, const int64_t* times, size_t count,
+                       int64_t from, int64_t to) {
+#ifdef GROCERY_HAVE_AVX2
+    if (avx2Active()) return sumInTimeRangeAvx2(values, times, count, from, to);
+#endif
+    return sumInTimeRangeScalar(values, times, count, from, to);
+}
+
+bool minMaxColumn(const int64_t* values, size_t count, int64_t& minValue, int64_t& maxValue) {
+    if (count == 0) {
+        return false;
+    }
+#ifdef GROCERY_HAVE_AVX2
+    if (avx2Active()) {
+        minMaxAvx2(values, count, minValue, maxValue);
+        return true;
+    }
+#endif
+    minMaxScalar(values, count, minValue, maxValue);
+    return true;
+}
+
+const char* aggregationKernelName() {
+    return avx2Active() ? "avx2" : "scalar";
+}
+
+void useScalarKernels(bool scalarOnly) {
+    scalarForced.store(scalarOnly, std::memory_order_relaxed);
+}
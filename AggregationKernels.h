@@ -0,0 +1,31 @@
+// AggregationKernels.h - Vectorized reductions over transaction columns
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef AGGREGATION_KERNELS_H
+#define AGGREGATION_KERNELS_H
+
+#include <cstdint>
+#include <cstddef>
+
+// Reductions over the integer-cent amount columns used by the sales
+// report. On x86 CPUs with AVX2 they handle four values per instruction;
+// everywhere else a scalar version is used. Integer sums are exact, so
+// both versions always return the same result.
+
+// Sum of values[0..count)
+int64_t sumColumn(const int64_t* values, size_t count);
+
+// Sum of values[i] for every i with from <= times[i] < to
+int64_t sumInTimeRange(const int64_t* values, const int64_t* times, size_t count,
+                       int64_t from, int64_t to);
+
+// Smallest and largest of values[0..count); returns false if count is 0
+bool minMaxColumn(const int64_t* values, size_t count, int64_t& minValue, int64_t& maxValue);
+
+// "avx2" or "scalar"
+const char* aggregationKernelName();
+
+// Force the scalar kernels (for comparisons); false restores CPU detection
+void useScalarKernels(bool scalarOnly);
+
+#endif // AGGREGATION_KERNELS_H
@@ -0,0 +1,525 @@
+#ifndef BPLUS_TREE_H
+#define BPLUS_TREE_H
+
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include "GroceryItem.h"
+#include "NodePool.h"
+
+// Inventory index laid out for the store's access pattern: mostly point
+// lookups by UPC plus ordered scans. Each node keeps its keys in one small
+// array (two cache lines), so a lookup touches a handful of lines per level
+// instead of one node per comparison as in the AVL tree. Items live only in
+// the leaves, and the leaves are linked in key order for range scans.
+//
+// Offers the same insert/search/update/remove calls as AVLTree, plus
+// rangeScan(fromUpc, toUpc).
+class BPlusTree {
+private:
+    static constexpr int kLeafKeys = 16;  // 16 x 8-byte keys = 128 bytes
+    static constexpr int kInnerKeys = 16;
+    static constexpr int kMinLeafKeys = kLeafKeys / 2;
+    static constexpr int kMinInnerKeys = kInnerKeys / 2;
+    static constexpr uint32_t nil = 0xFFFFFFFFu;
+
+    struct Leaf {
+        UpcKey keys[kLeafKeys];
+        int count;
+        uint32_t prev;
+        uint32_t next;
+        GroceryItem items[kLeafKeys];
+
+        Leaf() : count(0), prev(nil), next(nil) {}
+    };
+
+    // keys[i] is the smallest key reachable through children[i + 1].
+    struct Inner {
+        UpcKey keys[kInnerKeys];
+        int count;
+        uint32_t children[kInnerKeys + 1];
+
+        Inner() : count(0) {}
+    };
+
+    NodePool<Leaf> leaves;
+    NodePool<Inner> inners;
+    uint32_t root;
+    int levels; // number of inner levels above the leaves; 0 = root is a leaf
+    size_t itemCount;
+
+    // Result of inserting into a subtree that had to split.
+    struct Split {
+        UpcKey separator;
+        uint32_t right;
+    };
+
+    // Index of the first key > key (child slot to descend into).
+    static int upperBound(const UpcKey* keys, int count, UpcKey key) {
+        int i = 0;
+        while (i < count && keys[i] <= key) ++i;
+        return i;
+    }
+
+    // Index of the first key >= key.
+    static int lowerBound(const UpcKey* keys, int count, UpcKey key) {
+        int i = 0;
+        while (i < count && keys[i] < key) ++i;
+        return i;
+    }
+
+    uint32_t newLeaf() {
+        uint32_t index = leaves.allocate();
+        Leaf& leaf = leaves[index];
+        leaf.count = 0;
+        leaf.prev = nil;
+        leaf.next = nil;
+        return index;
+    }
+
+    void freeLeaf(uint32_t index) {
+        Leaf& leaf = leaves[index];
+        for (int i = 0; i < leaf.count; ++i) {
+            leaf.items[i] = GroceryItem();
+        }
+        leaf.count = 0;
+        leaves.release(index);
+    }
+
+    uint32_t newInner() {
+        uint32_t index = inners.allocate();
+        inners[index].count = 0;
+        return index;
+    }
+
+    // Descend to the leaf that would hold key.
+    uint32_t findLeaf(UpcKey key) const {
+        uint32_t node = root;
+        for (int level = levels; level > 0; --level) {
+            const Inner& inner = inners[node];
+            node = inner.children[upperBound(inner.keys, inner.count, key)];
+        }
+        return node;
+    }
+
+    void insertIntoLeaf(Leaf& leaf, int pos, const GroceryItem& item) {
+        for (int i = leaf.count; i > pos; --i) {
+            leaf.keys[i] = leaf.keys[i - 1];
+            leaf.items[i] = std::move(leaf.items[i - 1]);
+        }
+        leaf.keys[pos] = item.getUpc();
+        leaf.items[pos] = item;
+        leaf.count++;
+    }
+
+    // Returns false on a duplicate key. Sets didSplit when node split.
+    bool insertNode(uint32_t node, int level, const GroceryItem& item,
+                    bool& didSplit, Split& split) {
+        UpcKey key = item.getUpc();
+        didSplit = false;
+
+        if (level == 0) {
+            Leaf& leaf = leaves[node];
+            int pos = lowerBound(leaf.keys, leaf.count, key);
+            if (pos < leaf.count && leaf.keys[pos] == key)
+                return false; // Duplicate UPC codes not allowed
+
+            if (leaf.count < kLeafKeys) {
+                insertIntoLeaf(leaf, pos, item);
+                return true;
+            }
+
+            // Split the full leaf in half, then insert into the proper side
+            uint32_t rightIndex = newLeaf();
+            Leaf& left = leaves[node];
+            Leaf& right = leaves[rightIndex];
+            int half = kLeafKeys / 2;
+            for (int i = half; i < kLeafKeys; ++i) {
+                right.keys[i - half] = left.keys[i];
+                right.items[i - half] = std::move(left.items[i]);
+                left.items[i] = GroceryItem();
+            }
+            right.count = kLeafKeys - half;
+            left.count = half;
+
+            right.next = left.next;
+            right.prev = node;
+            if (left.next != nil) leaves[left.next].prev = rightIndex;
+            left.next = rightIndex;
+
+            if (pos <= half)
+                insertIntoLeaf(left, pos, item);
+            else
+                insertIntoLeaf(right, pos - half, item);
+
+            didSplit = true;
+            split.separator = right.keys[0];
+            split.right = rightIndex;
+            return true;
+        }
+
+        int slot = upperBound(inners[node].keys, inners[node].count, key);
+        bool childSplit = false;
+        Split childResult;
+        if (!insertNode(inners[node].children[slot], level - 1, item, childSplit, childResult))
+            return false;
+        if (!childSplit)
+            return true;
+
+        Inner& inner = inners[node];
+        if (inner.count < kInnerKeys) {
+            for (int i = inner.count; i > slot; --i) {
+                inner.keys[i] = inner.keys[i - 1];
+                inner.children[i + 1] = inner.children[i];
+            }
+            inner.keys[slot] = childResult.separator;
+            inner.children[slot + 1] = childResult.right;
+            inner.count++;
+            return true;
+        }
+
+        // Split a full inner node: gather into temporaries, push the
+        // middle key up and divide the rest between the two halves.
+        UpcKey keys[kInnerKeys + 1];
+        uint32_t children[kInnerKeys + 2];
+        for (int i = 0, j = 0; i <= kInnerKeys; ++i) {
+            keys[i] = (i == slot) ? childResult.separator : inner.keys[j++];
+        }
+        for (int i = 0, j = 0; i <= kInnerKeys + 1; ++i) {
+            children[i] = (i == slot + 1) ? childResult.right : inner.children[j++];
+        }
+
+        uint32_t rightIndex = newInner();
+        Inner& left = inners[node];
+        Inner& right = inners[rightIndex];
+        int mid = (kInnerKeys + 1) / 2;
+
+        left.count = mid;
+        for (int i = 0; i < mid; ++i) left.keys[i] = keys[i];
+        for (int i = 0; i <= mid; ++i) left.children[i] = children[i];
+
+        right.count = kInnerKeys - mid;
+        for (int i = 0; i < right.count; ++i) right.keys[i] = keys[mid + 1 + i];
+        for (int i = 0; i <= right.count; ++i) right.children[i] = children[mid + 1 + i];
+
+        didSplit = true;
+        split.separator = keys[mid];
+        split.right = rightIndex;
+        return true;
+    }
+
+    // Restore the minimum fill of parent.children[slot] by borrowing from
+    // or merging with an adjacent sibling.
+    void rebalanceChild(uint32_t parentIndex, int childLevel, int slot) {
+        Inner& parent = inners[parentIndex];
+        bool hasLeft = slot > 0;
+        int leftSlot = hasLeft ? slot - 1 : slot;
+        int sep = leftSlot; // separator between leftSlot and leftSlot + 1
+        uint32_t leftIndex = parent.children[leftSlot];
+        uint32_t rightIndex = parent.children[leftSlot + 1];
+
+        if (childLevel == 0) {
+            Leaf& left = leaves[leftIndex];
+            Leaf& right = leaves[rightIndex];
+
+            if (hasLeft && left.count > kMinLeafKeys) {
+                // Borrow the largest entry of the left sibling
+                for (int i = right.count; i > 0; --i) {
+                    right.keys[i] = right.keys[i - 1];
+                    right.items[i] = std::move(right.items[i - 1]);
+                }
+                right.keys[0] = left.keys[left.count - 1];
+                right.items[0] = std::move(left.items[left.count - 1]);
+                left.items[left.count - 1] = GroceryItem();
+                left.count--;
+                right.count++;
+                parent.keys[sep] = right.keys[0];
+                return;
+            }
+            if (!hasLeft && right.count > kMinLeafKeys) {
+                // Borrow the smallest entry of the right sibling
+                left.keys[left.count] = right.keys[0];
+                left.items[left.count] = std::move(right.items[0]);
+                left.count++;
+                for (int i = 1; i < right.count; ++i) {
+                    right.keys[i - 1] = right.keys[i];
+                    right.items[i - 1] = std::move(right.items[i]);
+                }
+                right.count--;
+                right.items[right.count] = GroceryItem();
+                parent.keys[sep] = right.keys[0];
+                return;
+            }
+
+            // Merge right into left and unlink right
+            for (int i = 0; i < right.count; ++i) {
+                left.keys[left.count + i] = right.keys[i];
+                left.items[left.count + i] = std::move(right.items[i]);
+            }
+            left.count += right.count;
+            right.count = 0;
+            left.next = right.next;
+            if (right.next != nil) leaves[right.next].prev = leftIndex;
+            freeLeaf(rightIndex);
+        } else {
+            Inner& left = inners[leftIndex];
+            Inner& right = inners[rightIndex];
+
+            if (hasLeft && left.count > kMinInnerKeys) {
+                // Rotate through the parent: separator moves down, left's last key moves up
+                for (int i = right.count; i > 0; --i) right.keys[i] = right.keys[i - 1];
+                for (int i = right.count + 1; i > 0; --i) right.children[i] = right.children[i - 1];
+                right.keys[0] = parent.keys[sep];
+                right.children[0] = left.children[left.count];
+                right.count++;
+                parent.keys[sep] = left.keys[left.count - 1];
+                left.count--;
+                return;
+            }
+            if (!hasLeft && right.count > kMinInnerKeys) {
+                left.keys[left.count] = parent.keys[sep];
+                left.children[left.count + 1] = right.children[0];
+                left.count++;
+                parent.keys[sep] = right.keys[0];
+                for (int i = 1; i < right.count; ++i) right.keys[i - 1] = right.keys[i];
+                for (int i = 1; i <= right.count; ++i) right.children[i - 1] = right.children[i];
+                right.count--;
+                return;
+            }
+
+            // Merge: left + separator + right
+            left.keys[left.count] = parent.keys[sep];
+            for (int i = 0; i < right.count; ++i) left.keys[left.count + 1 + i] = right.keys[i];
+            for (int i = 0; i <= right.count; ++i) left.children[left.count + 1 + i] = right.children[i];
+            left.count += right.count + 1;
+            inners.release(rightIndex);
+        }
+
+        // Drop the separator and the merged-away child from the parent
+        for (int i = sep; i < parent.count - 1; ++i) parent.keys[i] = parent.keys[i + 1];
+        for (int i = sep + 1; i < parent.count; ++i) parent.children[i] = parent.children[i + 1];
+        parent.count--;
+    }
+
+    bool removeNode(uint32_t node, int level, UpcKey key) {
+        if (level == 0) {
+            Leaf& leaf = leaves[node];
+            int pos = lowerBound(leaf.keys, leaf.count, key);
+            if (pos == leaf.count || leaf.keys[pos] != key)
+                return false;
+            for (int i = pos + 1; i < leaf.count; ++i) {
+                leaf.keys[i - 1] = leaf.keys[i];
+                leaf.items[i - 1] = std::move(leaf.items[i]);
+            }
+            leaf.count--;
+            leaf.items[leaf.count] = GroceryItem();
+            return true;
+        }
+
+        int slot = upperBound(inners[node].keys, inners[node].count, key);
+        uint32_t child = inners[node].children[slot];
+        if (!removeNode(child, level - 1, key))
+            return false;
+
+        int childCount = level == 1 ? leaves[child].count : inners[child].count;
+        int minimum = level == 1 ? kMinLeafKeys : kMinInnerKeys;
+        if (childCount < minimum)
+            rebalanceChild(node, level - 1, slot);
+        return true;
+    }
+
+    void printItem(const GroceryItem& item) const {
+        std::cout << "UPC: " << item.getUpc()
+                  << ", Name: " << item.getName()
+                  << ", Price: $" << item.getPrice()
+                  << ", Quantity: " << item.getQuantity()
+                  << ", Aisle: " << item.getAisle() << std::endl;
+    }
+
+public:
+    // Forward iterator over the items of a rangeScan, in UPC order.
+    class ScanIterator {
+    private:
+        const BPlusTree* tree;
+        uint32_t leaf;
+        int slot;
+        UpcKey last;
+
+        void settle() {
+            while (leaf != nil) {
+                const Leaf& l = tree->leaves[leaf];
+                if (slot < l.count) {
+                    if (l.keys[slot] > last) leaf = nil;
+                    return;
+                }
+                leaf = l.next;
+                slot = 0;
+            }
+        }
+
+    public:
+        ScanIterator() : tree(nullptr), leaf(nil), slot(0), last() {}
+        ScanIterator(const BPlusTree* t, uint32_t l, int s, UpcKey to)
+            : tree(t), leaf(l), slot(s), last(to) { settle(); }
+
+        const GroceryItem& operator*() const { return tree->leaves[leaf].items[slot]; }
+        const GroceryItem* operator->() const { return &tree->leaves[leaf].items[slot]; }
+
+        ScanIterator& operator++() {
+            ++slot;
+            settle();
+            return *this;
+        }
+
+        bool operator==(const ScanIterator& other) const {
+            return leaf == other.leaf && (leaf == nil || slot == other.slot);
+        }
+        bool operator!=(const ScanIterator& other) const { return !(*this == other); }
+    };
+
+    struct ScanRange {
+        ScanIterator first;
+        ScanIterator last;
+        ScanIterator begin() const { return first; }
+        ScanIterator end() const { return last; }
+    };
+
+    BPlusTree() : root(nil), levels(0), itemCount(0) {}
+
+    BPlusTree(const BPlusTree&) = delete;
+    BPlusTree& operator=(const BPlusTree&) = delete;
+
+    // Create operation - Insert a grocery item
+    void insert(const GroceryItem& item) {
+        if (!item.getUpc().isValid()) return; // Items need a parseable UPC
+        if (root == nil) {
+            root = newLeaf();
+            levels = 0;
+        }
+
+        bool didSplit = false;
+        Split split;
+        if (!insertNode(root, levels, item, didSplit, split))
+            return; // Duplicate UPC codes not allowed
+        itemCount++;
+
+        if (didSplit) {
+            // Grow a new root above the old one
+            uint32_t newRoot = newInner();
+            Inner& inner = inners[newRoot];
+            inner.count = 1;
+            inner.keys[0] = split.separator;
+            inner.children[0] = root;
+            inner.children[1] = split.right;
+            root = newRoot;
+            levels++;
+        }
+    }
+
+    // Read operation - Search for an item by UPC code
+    GroceryItem* search(UpcKey upcCode) {
+        if (root == nil) return nullptr;
+        Leaf& leaf = leaves[findLeaf(upcCode)];
+        int pos = lowerBound(leaf.keys, leaf.count, upcCode);
+        if (pos == leaf.count || leaf.keys[pos] != upcCode)
+            return nullptr;
+        return &leaf.items[pos];
+    }
+
+    const GroceryItem* search(UpcKey upcCode) const {
+        if (root == nil) return nullptr;
+        const Leaf& leaf = leaves[findLeaf(upcCode)];
+        int pos = lowerBound(leaf.keys, leaf.count, upcCode);
+        if (pos == leaf.count || leaf.keys[pos] != upcCode)
+            return nullptr;
+        return &leaf.items[pos];
+    }
+
+    GroceryItem* search(const std::string& upcCode) {
+        UpcKey key;
+        if (!UpcKey::parse(upcCode, key)) {
+            return nullptr;
+        }
+        return search(key);
+    }
+
+    // Update operation - Replace an item; its UPC must stay the same
+    bool update(UpcKey upcCode, const GroceryItem& newItem) {
+        if (newItem.getUpc() != upcCode) return false;
+        GroceryItem* item = search(upcCode);
+        if (item == nullptr) {
+            return false;
+        }
+        *item = newItem;
+        return true;
+    }
+
+    bool update(const std::string& upcCode, const GroceryItem& newItem) {
+        UpcKey key;
+        return UpcKey::parse(upcCode, key) && update(key, newItem);
+    }
+
+    // Delete operation - Remove an item by UPC code
+    bool remove(UpcKey upcCode) {
+        if (root == nil || !removeNode(root, levels, upcCode))
+            return false;
+        itemCount--;
+
+        // Shrink the tree when the root runs out of separators
+        if (levels > 0 && inners[root].count == 0) {
+            uint32_t oldRoot = root;
+            root = inners[oldRoot].children[0];
+            inners.release(oldRoot);
+            levels--;
+        } else if (levels == 0 && leaves[root].count == 0) {
+            freeLeaf(root);
+            root = nil;
+        }
+        return true;
+    }
+
+    bool remove(const std::string& upcCode) {
+        UpcKey key;
+        return UpcKey::parse(upcCode, key) && remove(key);
+    }
+
+    // Items with fromUpc <= UPC <= toUpc, in UPC order
+    ScanRange rangeScan(UpcKey fromUpc, UpcKey toUpc) const {
+        if (root == nil || toUpc < fromUpc)
+            return ScanRange{ScanIterator(), ScanIterator()};
+        uint32_t leaf = findLeaf(fromUpc);
+        int slot = lowerBound(leaves[leaf].keys, leaves[leaf].count, fromUpc);
+        return ScanRange{ScanIterator(this, leaf, slot, toUpc), ScanIterator()};
+    }
+
+    // Every item, in UPC order
+    ScanRange allItems() const {
+        return rangeScan(UpcKey::fromRaw(1), UpcKey::fromRaw(~0ull));
+    }
+
+    // Display all items in order (by UPC code)
+    void displayAllItems() const {
+        if (root == nil) {
+            std::cout << "Inventory is empty." << std::endl;
+            return;
+        }
+
+        std::cout << "-------- GROCERY INVENTORY --------" << std::endl;
+        for (const GroceryItem& item : allItems()) {
+            printItem(item);
+        }
+        std::cout << "----------------------------------" << std::endl;
+    }
+
+    // Check if the tree is empty
+    bool isEmpty() const {
+        return root == nil;
+    }
+
+    // Number of items currently stored
+    size_t size() const {
+        return itemCount;
+    }
+};
+
+#endif
@@ -0,0 +1,220 @@
+// CatalogIndex.h - Secondary indexes on aisle and item name
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef CATALOG_INDEX_H
+#define CATALOG_INDEX_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "GroceryItem.h"
+
+// Lookups ignore ASCII case, so "dairy" finds items in aisle "Dairy"
+inline std::string foldCase(std::string_view text) {
+    std::string folded(text);
+    for (char& c : folded) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return folded;
+}
+
+// A [begin, end) pair usable in a range-for
+template <typename Iterator>
+struct IteratorRange {
+    Iterator first;
+    Iterator last;
+
+    Iterator begin() const { return first; }
+    Iterator end() const { return last; }
+    bool empty() const { return first == last; }
+    size_t size() const { return static_cast<size_t>(std::distance(first, last)); }
+};
+
+// Aisle -> UPCs of the items shelved there. Each UPC also remembers its
+// slot in the aisle's list, so removal swaps the last entry into the gap
+// in O(1). The order within an aisle is not meaningful.
+class AisleIndex {
+private:
+    std::unordered_map<std::string, std::vector<UpcKey>> byAisle; // folded aisle name
+    std::unordered_map<UpcKey, uint32_t> slotOf;
+
+public:
+    using Range = IteratorRange<std::vector<UpcKey>::const_iterator>;
+
+    void add(std::string_view aisle, UpcKey upc) {
+        std::vector<UpcKey>& members = byAisle[foldCase(aisle)];
+        slotOf[upc] = static_cast<uint32_t>(members.size());
+        members.push_back(upc);
+    }
+
+    void remove(std::string_view aisle, UpcKey upc) {
+        auto list = byAisle.find(foldCase(aisle));
+        auto slot = slotOf.find(upc);
+        if (list == byAisle.end() || slot == slotOf.end()) return;
+        std::vector<UpcKey>& members = list->second;
+        uint32_t position = slot->second;
+        slotOf.erase(slot);
+        if (position != members.size() - 1) {
+            members[position] = members.back();
+            slotOf[members[position]] = position;
+        }
+        members.pop_back();
+        if (members.empty()) byAisle.erase(list);
+    }
+
+    Range find(std::string_view aisle) const {
+        static const std::vector<UpcKey> none;
+        auto list = byAisle.find(foldCase(aisle));
+        const std::vector<UpcKey>& members = list == byAisle.end() ? none : list->second;
+        return Range{members.begin(), members.end()};
+    }
+
+    // Every aisle that has at least one item (folded names)
+    std::vector<std::string> aisles() const {
+        std::vector<std::string> names;
+        names.reserve(byAisle.size());
+        for (const auto& entry : byAisle) names.push_back(entry.first);
+        return names;
+    }
+
+    void reserve(size_t items) { slotOf.reserve(items); }
+
+    void clear() {
+        byAisle.clear();
+        slotOf.clear();
+    }
+};
+
+// (folded name, UPC) pairs in one sorted array, so every name starting
+// with a prefix sits in one contiguous run found with two binary searches.
+// A bulk load appends everything and sorts once; a single add or remove
+// (a menu edit) shifts the tail of the array.
+class NamePrefixIndex {
+private:
+    using Entries = std::vector<std::pair<std::string, UpcKey>>;
+    Entries entries;
+
+    Entries::const_iterator lowerBound(const std::string& name, UpcKey upc) const {
+        return std::lower_bound(entries.begin(), entries.end(), std::make_pair(name, upc));
+    }
+
+public:
+    // Walks a run of entries and yields their UPCs
+    class Iterator {
+    private:
+        Entries::const_iterator at;
+
+    public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = UpcKey;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const UpcKey*;
+        using reference = const UpcKey&;
+
+        Iterator() = default;
+        explicit Iterator(Entries::const_iterator position) : at(position) {}
+
+        const UpcKey& operator*() const { return at->second; }
+        const UpcKey* operator->() const { return &at->second; }
+        const std::string& foldedName() const { return at->first; }
+        Iterator& operator++() { ++at; return *this; }
+        Iterator operator++(int) { Iterator old = *this; ++at; return old; }
+        Iterator& operator--() { --at; return *this; }
+        Iterator operator--(int) { Iterator old = *this; --at; return old; }
+        bool operator==(const Iterator& other) const { return at == other.at; }
+        bool operator!=(const Iterator& other) const { return at != other.at; }
+    };
+
+    using Range = IteratorRange<Iterator>;
+
+    void add(std::string_view name, UpcKey upc) {
+        std::string folded = foldCase(name);
+        auto position = lowerBound(folded, upc);
+        if (position != entries.end() && position->first == folded && position->second == upc) return;
+        entries.emplace(position, std::move(folded), upc);
+    }
+
+    void remove(std::string_view name, UpcKey upc) {
+        std::string folded = foldCase(name);
+        auto position = lowerBound(folded, upc);
+        if (position != entries.end() && position->first == folded && position->second == upc) {
+            entries.erase(position);
+        }
+    }
+
+    // Bulk load: append() every item in any order, then sortAppended()
+    // once. Lookups are only valid after the sort.
+    void append(std::string_view name, UpcKey upc) {
+        entries.emplace_back(foldCase(name), upc);
+    }
+
+    void sortAppended() {
+        std::sort(entries.begin(), entries.end());
+        entries.erase(std::unique(entries.begin(), entries.end()), entries.end());
+    }
+
+    // Items whose name starts with prefix, in name order
+    Range withPrefix(std::string_view prefix) const {
+        std::string low = foldCase(prefix);
+        auto first = lowerBound(low, UpcKey());
+        // The first string past every extension of low: drop trailing
+        // 0xFF bytes, then bump the last remaining byte
+        std::string high = low;
+        while (!high.empty() && static_cast<unsigned char>(high.back()) == 0xFF) high.pop_back();
+        if (high.empty()) return Range{Iterator(first), Iterator(entries.end())};
+        high.back() = static_cast<char>(static_cast<unsigned char>(high.back()) + 1);
+        auto last = lowerBound(high, UpcKey());
+        return Range{Iterator(first), Iterator(last)};
+    }
+
+    void reserve(size_t items) { entries.reserve(items); }
+
+    void clear() { entries.clear(); }
+};
+
+// Both indexes, kept in step with an inventory by AVLTree
+class CatalogIndex {
+private:
+    AisleIndex aisleIndex;
+    NamePrefixIndex nameIndex;
+
+public:
+    void add(const GroceryItem& item) {
+        aisleIndex.add(item.getAisle(), item.getUpc());
+        nameIndex.add(item.getName(), item.getUpc());
+    }
+
+    void remove(const GroceryItem& item) {
+        aisleIndex.remove(item.getAisle(), item.getUpc());
+        nameIndex.remove(item.getName(), item.getUpc());
+    }
+
+    // Bulk load: appendUnsorted() every item, then finishAppending()
+    void appendUnsorted(const GroceryItem& item) {
+        aisleIndex.add(item.getAisle(), item.getUpc());
+        nameIndex.append(item.getName(), item.getUpc());
+    }
+
+    void finishAppending() { nameIndex.sortAppended(); }
+
+    AisleIndex::Range inAisle(std::string_view aisle) const { return aisleIndex.find(aisle); }
+    NamePrefixIndex::Range withNamePrefix(std::string_view prefix) const { return nameIndex.withPrefix(prefix); }
+    std::vector<std::string> aisles() const { return aisleIndex.aisles(); }
+
+    void reserve(size_t items) {
+        aisleIndex.reserve(items);
+        nameIndex.reserve(items);
+    }
+
+    void clear() {
+        aisleIndex.clear();
+        nameIndex.clear();
+    }
+};
+
+#endif // CATALOG_INDEX_H
@@ -0,0 +1,214 @@
+// CatalogLoader.cpp - Bulk catalog import and export
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "CatalogLoader.h"
+#include "AVLTree.h"
+#include "LoaderUtil.h"
+#include "MappedFile.h"
+#include "TransactionJournal.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <string_view>
+
+namespace {
+
+const char kCatalogMagic[4] = {'G', 'C', 'A', 'T'};
+constexpr uint32_t kCatalogVersion = 1;
+constexpr size_t kCatalogHeaderSize = 16;
+
+bool byUpc(const GroceryItem& a, const GroceryItem& b) {
+    return a.getUpc() < b.getUpc();
+}
+
+// Parse "upc,name,price,quantity,aisle"; the name is everything between
+// the first comma and the third-from-last one, and may not be empty
+bool parseCatalogLine(std::string_view line, std::vector<GroceryItem>& out) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+    size_t firstComma = line.find(',');
+    size_t aisleComma = line.rfind(',');
+    if (firstComma == std::string_view::npos || aisleComma <= firstComma) return false;
+    size_t quantityComma = line.rfind(',', aisleComma - 1);
+    if (quantityComma == std::string_view::npos || quantityComma <= firstComma) return false;
+    size_t priceComma = line.rfind(',', quantityComma - 1);
+    if (priceComma == std::string_view::npos || priceComma <= firstComma) return false;
+
+    UpcKey upc;
+    Money price;
+    int quantity;
+    if (!UpcKey::parse(line.substr(0, firstComma), upc) ||
+        !Money::parse(line.substr(priceComma + 1, quantityComma - priceComma - 1), price) ||
+        !parseNumber(line.substr(quantityComma + 1, aisleComma - quantityComma - 1), quantity)) {
+        return false;
+    }
+    std::string_view name = line.substr(firstComma + 1, priceComma - firstComma - 1);
+    if (name.empty()) return false;
+    std::string_view aisle = line.substr(aisleComma + 1);
+    out.emplace_back(name, upc, price, quantity, aisle);
+    return true;
+}
+
+// Parse the CSV in one chunk per thread, cut at line boundaries
+std::vector<GroceryItem> readCatalogCsv(std::string_view text, CatalogLoadResult& result) {
+    size_t parts = loaderThreadsFor(text.size());
+    std::vector<size_t> bounds = splitAtLines(text, parts);
+    std::vector<std::vector<GroceryItem>> parsed(parts);
+    std::vector<size_t> rows(parts, 0);
+    std::vector<size_t> bad(parts, 0);
+    runParallel(parts, [&](size_t part) {
+        std::string_view chunk = text.substr(bounds[part], bounds[part + 1] - bounds[part]);
+        parsed[part].reserve(chunk.size() / 32);
+        bool first = part == 0;
+        while (!chunk.empty()) {
+            std::string_view line = nextField(chunk, '\n');
+            if (line.empty() || line == "\r") continue;
+            rows[part]++;
+            if (!parseCatalogLine(line, parsed[part])) {
+                // Header row, not a bad item
+                if (first) rows[part]--;
+                else bad[part]++;
+            }
+            first = false;
+        }
+    });
+
+    size_t total = 0;
+    for (size_t part = 0; part < parts; ++part) {
+        total += parsed[part].size();
+        result.rows += rows[part];
+        result.malformed += bad[part];
+    }
+    std::vector<GroceryItem> items;
+    items.reserve(total);
+    for (std::vector<GroceryItem>& part : parsed) {
+        std::move(part.begin(), part.end(), std::back_inserter(items));
+    }
+    return items;
+}
+
+std::vector<GroceryItem> readCatalogBinary(const unsigned char* data, size_t size, CatalogLoadResult& result) {
+    std::vector<GroceryItem> items;
+    ByteReader header(data + 4, kCatalogHeaderSize - 4);
+    uint32_t version;
+    uint64_t count;
+    if (!header.getU32(version) || !header.getU64(count) || version != kCatalogVersion) {
+        result.opened = false;
+        return items;
+    }
+
+    ByteReader reader(data + kCatalogHeaderSize, size - kCatalogHeaderSize);
+    items.reserve(static_cast<size_t>(std::min<uint64_t>(count, reader.remaining() / 24)));
+    std::string_view name, aisle;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t upc;
+        int64_t cents;
+        int32_t quantity;
+        if (!reader.getU64(upc) || !reader.getI64(cents) || !reader.getI32(quantity) ||
+            !reader.getString(name) || !reader.getString(aisle)) {
+            result.malformed++; // truncated file; keep what was read
+            break;
+        }
+        result.rows++;
+        items.emplace_back(name, UpcKey::fromRaw(upc), Money::fromCents(cents), quantity, aisle);
+    }
+    return items;
+}
+
+// Stable sort in parallel: each thread sorts a slice, then neighbouring
+// slices are merged pairwise until one run is left
+void parallelStableSort(std::vector<GroceryItem>& items) {
+    size_t parts = std::min(loaderThreadsFor(items.size() * 64), std::max<size_t>(items.size() / 4096, 1));
+    std::vector<size_t> bounds(parts + 1);
+    for (size_t part = 0; part <= parts; ++part) {
+        bounds[part] = items.size() * part / parts;
+    }
+    runParallel(parts, [&](size_t part) {
+        std::stable_sort(items.begin() + bounds[part], items.begin() + bounds[part + 1], byUpc);
+    });
+    for (size_t width = 1; width < parts; width *= 2) {
+        size_t merges = (parts + 2 * width - 1) / (2 * width);
+        runParallel(merges, [&](size_t merge) {
+            size_t lo = merge * 2 * width;
+            size_t mid = std::min(lo + width, parts);
+            size_t hi = std::min(lo + 2 * width, parts);
+            if (mid < hi) {
+                std::inplace_merge(items.begin() + bounds[lo], items.begin() + bounds[mid],
+                                   items.begin() + bounds[hi], byUpc);
+            }
+        });
+    }
+}
+
+} // namespace
+
+void prepareSortedCatalog(std::vector<GroceryItem>& items, CatalogLoadResult& result) {
+    auto invalid = [](const GroceryItem& item) { return !item.getUpc().isValid(); };
+    size_t before = items.size();
+    items.erase(std::remove_if(items.begin(), items.end(), invalid), items.end());
+    result.malformed += before - items.size();
+
+    result.wasSorted = std::is_sorted(items.begin(), items.end(), byUpc);
+    if (!result.wasSorted) {
+        parallelStableSort(items);
+    }
+
+    // Stable order keeps the first row of each UPC in front
+    auto sameUpc = [](const GroceryItem& a, const GroceryItem& b) { return a.getUpc() == b.getUpc(); };
+    before = items.size();
+    items.erase(std::unique(items.begin(), items.end(), sameUpc), items.end());
+    result.duplicates += before - items.size();
+}
+
+CatalogLoadResult loadCatalog(const std::string& path, AVLTree& inventory) {
+    CatalogLoadResult result{false, 0, 0, 0, 0, true};
+    MappedFile file;
+    if (!file.open(path)) {
+        return result;
+    }
+    result.opened = true;
+
+    std::vector<GroceryItem> items;
+    if (file.size() >= kCatalogHeaderSize && std::memcmp(file.data(), kCatalogMagic, 4) == 0) {
+        items = readCatalogBinary(file.data(), file.size(), result);
+    } else {
+        items = readCatalogCsv(file.view(), result);
+    }
+    file.close();
+    if (!result.opened) {
+        return result;
+    }
+
+    prepareSortedCatalog(items, result);
+    result.loaded = items.size();
+    inventory.assignSorted(std::move(items));
+    return result;
+}
+
+bool saveCatalogBinary(const std::string& path, const AVLTree& inventory) {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (out == nullptr) {
+        return false;
+    }
+    std::vector<unsigned char> buffer;
+    ByteWriter writer(buffer);
+    for (char c : kCatalogMagic) writer.putU8(static_cast<uint8_t>(c));
+    writer.putU32(kCatalogVersion);
+    writer.putU64(inventory.size());
+
+    bool ok = true;
+    inventory.forEachItem([&](const GroceryItem& item) {
+        writer.putU64(item.getUpc().raw());
+        writer.putI64(item.getPrice().getCents());
+        writer.putI32(item.getQuantity());
+        writer.putString(item.getName());
+        writer.putString(item.getAisle());
+        if (buffer.size() >= (size_t(1) << 20)) {
+            ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+            buffer.clear();
+        }
+    });
+    ok = ok && std::fwrite(buffer.data(), 1, buffer.size(), out) == buffer.size();
+    return std::fclose(out) == 0 && ok;
+}
@@ -0,0 +1,45 @@
+// CatalogLoader.h - Bulk import and export of the store catalog
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef CATALOG_LOADER_H
+#define CATALOG_LOADER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "GroceryItem.h"
+
+class AVLTree;
+
+// Catalog files come in two formats, told apart by their first bytes:
+//
+//   CSV    : one item per line, "upc,name,price,quantity,aisle". A name
+//            may contain commas (the other fields are taken from the ends
+//            of the line) but may not be empty. A first line that does not
+//            parse is treated as a header.
+//   binary : "GCAT" magic, u32 format version, u64 item count, then per
+//            item: u64 packed UpcKey, i64 price in cents, i32 quantity,
+//            u16-length name, u16-length aisle. Little-endian.
+struct CatalogLoadResult {
+    bool opened;
+    size_t rows;       // lines or records read
+    size_t loaded;     // items now in the inventory
+    size_t malformed;  // rows that did not parse or had an invalid UPC
+    size_t duplicates; // rows whose UPC appeared earlier in the file (first wins)
+    bool wasSorted;    // rows arrived in ascending UPC order
+};
+
+// Replace inventory with the catalog in path. Rows already in UPC order
+// go straight into a bottom-up tree build; otherwise they are sorted in
+// parallel first.
+CatalogLoadResult loadCatalog(const std::string& path, AVLTree& inventory);
+
+// Write inventory in the binary catalog format, in UPC order
+bool saveCatalogBinary(const std::string& path, const AVLTree& inventory);
+
+// Sort items by UPC (stable, in parallel for large inputs), drop invalid
+// keys and later duplicates, and count what was dropped
+void prepareSortedCatalog(std::vector<GroceryItem>& items, CatalogLoadResult& result);
+
+#endif // CATALOG_LOADER_H
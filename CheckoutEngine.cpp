@@ -0,0 +1,112 @@
+// CheckoutEngine.cpp - Checkout pricing and the standard receipt sinks
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "CheckoutEngine.h"
+#include "AVLTree.h"
+#include "TransactionProcessing.h"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+CheckoutEngine::CheckoutEngine(int64_t taxBasisPoints, size_t expectedLines)
+    : taxBasisPoints(taxBasisPoints) {
+    receipt.lines.reserve(expectedLines);
+    receipt.taxBasisPoints = taxBasisPoints;
+}
+
+void CheckoutEngine::addSink(ReceiptSink* sink) {
+    if (sink != nullptr) {
+        sinks.push_back(sink);
+    }
+}
+
+const Receipt& CheckoutEngine::price(const ShoppingCart& cart, Money discount) {
+    receipt.lines.clear();
+    receipt.subtotal = Money();
+    receipt.itemCount = 0;
+    for (const CartLine& line : cart.getLines()) {
+        Money amount = line.unitPrice * line.quantity;
+        receipt.lines.push_back(ReceiptLine{line.upc, line.sku, line.unitPrice, line.quantity, amount});
+        receipt.subtotal += amount;
+        receipt.itemCount += line.quantity;
+    }
+    std::sort(receipt.lines.begin(), receipt.lines.end(),
+              [](const ReceiptLine& a, const ReceiptLine& b) { return a.upc < b.upc; });
+
+    // A discount can bring the taxable amount down to zero but not below
+    receipt.discount = std::min(discount, receipt.subtotal);
+    Money taxable = receipt.subtotal - receipt.discount;
+    receipt.tax = taxable.percent(taxBasisPoints, Rounding::HalfUp);
+    receipt.total = taxable + receipt.tax;
+    return receipt;
+}
+
+const Receipt& CheckoutEngine::checkout(ShoppingCart& cart, Money discount) {
+    price(cart, discount);
+    for (ReceiptSink* sink : sinks) {
+        sink->onCheckout(receipt);
+    }
+    cart.clearCart();
+    return receipt;
+}
+
+void ConsoleReceiptPrinter::onCheckout(const Receipt& receipt) {
+    std::cout << "\n--- Receipt ---" << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    for (const ReceiptLine& line : receipt.lines) {
+        const GroceryItem* item = inventory.search(line.upc);
+        std::cout << "  ";
+        if (item != nullptr) {
+            std::cout << item->getName();
+        } else {
+            std::cout << "Item #" << line.upc;
+        }
+        std::cout << " x" << line.quantity << " @ $" << line.unitPrice
+                  << " = $" << line.amount << std::endl;
+    }
+    std::cout << "Subtotal: $" << receipt.subtotal << std::endl;
+    if (receipt.discount > Money()) {
+        std::cout << "Discount: -$" << receipt.discount << std::endl;
+    }
+    std::cout << "Tax (" << receipt.taxBasisPoints / 100;
+    if (receipt.taxBasisPoints % 100 != 0) {
+        std::cout << '.' << std::setw(2) << std::setfill('0') << receipt.taxBasisPoints % 100
+                  << std::setfill(' ');
+    }
+    std::cout << "%): $" << receipt.tax << std::endl;
+    std::cout << "Total: $" << receipt.total << std::endl;
+}
+
+TransactionLogSink::TransactionLogSink(TransactionManager& transactions, const AVLTree& inventory,
+                                       int customerId, const std::string& customerName)
+    : transactions(transactions), inventory(inventory), customerId(customerId),
+      customerName(customerName), lastTransactionId(-1), managerLock(nullptr) {}
+
+void TransactionLogSink::setCustomer(int id, const std::string& name) {
+    customerId = id;
+    customerName = InternedString(name);
+}
+
+void TransactionLogSink::onCheckout(const Receipt& receipt) {
+    items.clear();
+    items.reserve(receipt.lines.size());
+    for (const ReceiptLine& line : receipt.lines) {
+        const GroceryItem* item = inventory.search(line.upc);
+        if (item != nullptr) {
+            items.emplace_back(*item, line.quantity);
+        } else {
+            items.emplace_back(GroceryItem("Item #" + line.upc.toString(), line.upc, line.unitPrice, 0, ""),
+                               line.quantity);
+        }
+        // The receipt's price is what was charged, even if the shelf price changed since
+        items.back().first.setPrice(line.unitPrice);
+    }
+    std::unique_lock<std::mutex> guard;
+    if (managerLock != nullptr) {
+        guard = std::unique_lock<std::mutex>(*managerLock);
+    }
+    // The transaction keeps the vector; the next checkout sizes a new one
+    lastTransactionId = transactions.addTransaction(customerId, customerName, std::move(items),
+                                                    receipt.subtotal, receipt.discount,
+                                                    receipt.tax, receipt.total);
+}
@@ -0,0 +1,118 @@
+// CheckoutEngine.h - Pricing of a cart at checkout, without console I/O
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef CHECKOUT_ENGINE_H
+#define CHECKOUT_ENGINE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Money.h"
+#include "ShoppingCart.h"
+
+class TransactionManager;
+
+struct ReceiptLine {
+    UpcKey upc;
+    SkuHandle sku;
+    Money unitPrice;
+    int quantity;
+    Money amount; // unitPrice * quantity
+};
+
+// A priced cart. Lines are in UPC order. Tax is charged on
+// subtotal - discount and rounded half up to the cent.
+struct Receipt {
+    std::vector<ReceiptLine> lines;
+    Money subtotal;
+    Money discount;
+    Money tax;
+    Money total;
+    int itemCount;
+    int64_t taxBasisPoints;
+
+    Receipt() : itemCount(0), taxBasisPoints(0) {}
+};
+
+// Something that wants to see every completed checkout (a receipt
+// printer, the transaction log, a lane display)
+class ReceiptSink {
+public:
+    virtual ~ReceiptSink() = default;
+    virtual void onCheckout(const Receipt& receipt) = 0;
+};
+
+// Turns a cart into a Receipt. The engine keeps one Receipt and refills
+// it for every checkout, so once its line buffer has grown to the largest
+// cart seen, pricing does not allocate. Printing and logging are left to
+// whichever sinks are attached; with none attached the engine does no I/O.
+class CheckoutEngine {
+private:
+    int64_t taxBasisPoints;
+    Receipt receipt;
+    std::vector<ReceiptSink*> sinks;
+
+public:
+    static constexpr int64_t kDefaultTaxBasisPoints = 825; // 8.25%
+
+    explicit CheckoutEngine(int64_t taxBasisPoints = kDefaultTaxBasisPoints, size_t expectedLines = 64);
+
+    CheckoutEngine(const CheckoutEngine&) = delete;
+    CheckoutEngine& operator=(const CheckoutEngine&) = delete;
+
+    // Sinks are called in the order added and are not owned
+    void addSink(ReceiptSink* sink);
+
+    // Price the cart without changing it. The reference stays valid until
+    // the next call to price or checkout.
+    const Receipt& price(const ShoppingCart& cart, Money discount = Money());
+
+    // Price the cart, hand the receipt to every sink, then empty the cart
+    // (its stock stays sold)
+    const Receipt& checkout(ShoppingCart& cart, Money discount = Money());
+
+    int64_t getTaxBasisPoints() const { return taxBasisPoints; }
+};
+
+// Prints a receipt to std::cout, taking names from the inventory
+class ConsoleReceiptPrinter : public ReceiptSink {
+private:
+    const AVLTree& inventory;
+
+public:
+    explicit ConsoleReceiptPrinter(const AVLTree& inventory) : inventory(inventory) {}
+    void onCheckout(const Receipt& receipt) override;
+};
+
+// Records every checkout with a TransactionManager
+class TransactionLogSink : public ReceiptSink {
+private:
+    TransactionManager& transactions;
+    const AVLTree& inventory;
+    int customerId;
+    InternedString customerName;
+    int lastTransactionId;
+    std::mutex* managerLock;
+    std::vector<std::pair<GroceryItem, int>> items; // filled per checkout, then moved into the transaction
+
+public:
+    TransactionLogSink(TransactionManager& transactions, const AVLTree& inventory,
+                       int customerId = -1, const std::string& customerName = "Guest");
+
+    // Customer for the following checkouts (-1 for guest)
+    void setCustomer(int id, const std::string& name);
+
+    // TransactionManager is not thread-safe; when several lanes log to the
+    // same one, give each lane's sink the same lock
+    void setManagerLock(std::mutex* lock) { managerLock = lock; }
+
+    void onCheckout(const Receipt& receipt) override;
+
+    // ID given to the most recent checkout, or -1 before the first
+    int getLastTransactionId() const { return lastTransactionId; }
+};
+
+#endif // CHECKOUT_ENGINE_H
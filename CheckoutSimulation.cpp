@@ -0,0 +1,320 @@
+// CheckoutSimulation.cpp - Multi-lane checkout simulation
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "CheckoutSimulation.h"
+#include "AVLTree.h"
+#include "CheckoutEngine.h"
+#include "ConcurrentInventory.h"
+#include "ShoppingCart.h"
+#include "TransactionProcessing.h"
+#include "VersionedInventory.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Pause between the auditor's stock valuations
+constexpr std::chrono::milliseconds kAuditPeriod(2);
+
+struct Customer {
+    uint32_t id;
+    Clock::time_point arrived;
+    ShoppingCart cart;
+};
+
+struct Lane {
+    std::mutex lock;
+    std::deque<Customer*> line;
+    bool serving = false; // a service task is queued or running
+    size_t served = 0;
+    size_t joins = 0;
+    size_t queueSum = 0;
+    size_t maxQueue = 0;
+
+    CheckoutEngine engine;
+    std::unique_ptr<TransactionLogSink> log;
+};
+
+class Simulation {
+private:
+    const SimulationConfig& config;
+    ConcurrentInventory inventory;
+    VersionedInventory versioned; // used instead with StockStore::Versioned
+    std::vector<UpcKey> skus;
+    TransactionManager transactions;
+    std::mutex transactionLock;
+    std::vector<std::unique_ptr<Lane>> lanes;
+    std::vector<std::unique_ptr<Customer>> customers;
+    std::vector<double> latencyMicros; // by customer id
+    std::atomic<size_t> rejected;
+    std::atomic<size_t> checkouts;
+    std::atomic<int64_t> unitsSold;
+    std::atomic<bool> trading;
+    size_t audits;
+    size_t auditMismatches;
+    WorkStealingPool pool;
+
+    size_t basketSize(std::mt19937_64& rng) const {
+        size_t mean = std::max<size_t>(config.meanBasketSize, 1);
+        switch (config.basket) {
+        case BasketDistribution::Fixed:
+            return mean;
+        case BasketDistribution::Uniform:
+            return std::uniform_int_distribution<size_t>(1, 2 * mean - 1)(rng);
+        case BasketDistribution::Geometric:
+            return 1 + std::geometric_distribution<size_t>(1.0 / mean)(rng);
+        }
+        return mean;
+    }
+
+    void shop(Customer& customer) {
+        std::mt19937_64 rng(config.seed * 0x9E3779B97F4A7C15ull + customer.id);
+        std::uniform_int_distribution<size_t> pick(0, skus.size() - 1);
+        std::uniform_int_distribution<int> quantity(1, 3);
+        size_t items = basketSize(rng);
+        for (size_t i = 0; i < items; ++i) {
+            UpcKey upc = skus[pick(rng)];
+            StockStatus status = config.stock == StockStore::Versioned
+                                     ? customer.cart.tryAddItem(versioned, upc, quantity(rng))
+                                     : customer.cart.tryAddItem(inventory, upc, quantity(rng));
+            if (status != StockStatus::Ok) {
+                rejected.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        joinShortestLane(customer);
+    }
+
+    void joinShortestLane(Customer& customer) {
+        // Each lane is locked only while its length is read, so the choice
+        // can be slightly stale by the time the customer joins, much like a
+        // real shopper's. Ties go to the first lane counting
+        // from a per-customer start, so idle lanes share the load.
+        size_t best = 0;
+        size_t bestLength = SIZE_MAX;
+        for (size_t k = 0; k < lanes.size(); ++k) {
+            size_t i = (customer.id + k) % lanes.size();
+            std::lock_guard<std::mutex> guard(lanes[i]->lock);
+            size_t length = lanes[i]->line.size() + (lanes[i]->serving ? 1 : 0);
+            if (length < bestLength) {
+                best = i;
+                bestLength = length;
+            }
+        }
+
+        Lane& lane = *lanes[best];
+        bool startService = false;
+        {
+            std::lock_guard<std::mutex> guard(lane.lock);
+            lane.joins++;
+            lane.queueSum += lane.line.size();
+            lane.maxQueue = std::max(lane.maxQueue, lane.line.size());
+            lane.line.push_back(&customer);
+            if (!lane.serving) {
+                lane.serving = true;
+                startService = true;
+            }
+        }
+        if (startService) {
+            pool.submit([this, &lane] { serve(lane); });
+        }
+    }
+
+    // Check out everyone in the lane's line, one at a time
+    void serve(Lane& lane) {
+        while (true) {
+            Customer* customer;
+            {
+                std::lock_guard<std::mutex> guard(lane.lock);
+                if (lane.line.empty()) {
+                    lane.serving = false;
+                    return;
+                }
+                customer = lane.line.front();
+                lane.line.pop_front();
+            }
+            if (!customer->cart.isEmpty()) {
+                unitsSold.fetch_add(customer->cart.getTotalItems(), std::memory_order_relaxed);
+                lane.engine.checkout(customer->cart);
+                checkouts.fetch_add(1, std::memory_order_relaxed);
+            }
+            lane.served++;
+            latencyMicros[customer->id] =
+                std::chrono::duration<double, std::micro>(Clock::now() - customer->arrived).count();
+        }
+    }
+
+    // Value the stock from one snapshot, as a report would, and check the
+    // walk agrees with the totals the snapshot carries. Lanes keep
+    // committing the whole time; the snapshot does not move.
+    void audit() {
+        while (trading.load(std::memory_order_acquire)) {
+            InventorySnapshot view = versioned.snapshot();
+            int64_t units = 0;
+            Money value;
+            view.forEachItem([&](const GroceryItem& item) {
+                units += item.getQuantity();
+                value += item.getPrice() * item.getQuantity();
+            });
+            audits++;
+            if (units != view.totalUnits() || value != view.totalValue()) auditMismatches++;
+            std::this_thread::sleep_for(kAuditPeriod);
+        }
+    }
+
+    // Units and value left on the shelves
+    void countStock(SimulationReport& report) const {
+        report.unitsOnHand = 0;
+        report.valueOnHand = Money();
+        if (config.stock == StockStore::Versioned) {
+            InventorySnapshot view = versioned.snapshot();
+            report.unitsOnHand = view.totalUnits();
+            report.valueOnHand = view.totalValue();
+            return;
+        }
+        GroceryItem item;
+        for (UpcKey upc : skus) {
+            if (inventory.lookup(upc, item)) {
+                report.unitsOnHand += item.getQuantity();
+                report.valueOnHand += item.getPrice() * item.getQuantity();
+            }
+        }
+    }
+
+public:
+    Simulation(const AVLTree& catalog, const SimulationConfig& config)
+        : config(config), transactions(config.logFile, ""), rejected(0), checkouts(0),
+          unitsSold(0), trading(false), audits(0), auditMismatches(0), pool(config.threads) {
+        std::vector<GroceryItem> stocked;
+        catalog.forEachItem([&](const GroceryItem& item) {
+            stocked.push_back(item);
+            if (config.stockPerItem > 0) stocked.back().setQuantity(config.stockPerItem);
+            skus.push_back(item.getUpc());
+        });
+        if (config.stock == StockStore::Versioned) {
+            versioned.assignSorted(stocked); // forEachItem runs in UPC order
+        } else {
+            for (const GroceryItem& item : stocked) inventory.insert(item);
+        }
+
+        size_t laneCount = std::max<size_t>(config.lanes, 1);
+        for (size_t i = 0; i < laneCount; ++i) {
+            auto lane = std::make_unique<Lane>();
+            lane->log = std::make_unique<TransactionLogSink>(transactions, catalog);
+            lane->log->setManagerLock(&transactionLock);
+            lane->engine.addSink(lane->log.get());
+            lanes.push_back(std::move(lane));
+        }
+        customers.reserve(config.customers);
+        for (size_t i = 0; i < config.customers; ++i) {
+            customers.push_back(std::make_unique<Customer>());
+            customers.back()->id = static_cast<uint32_t>(i);
+        }
+        latencyMicros.assign(config.customers, 0.0);
+    }
+
+    SimulationReport run() {
+        SimulationReport report{};
+        report.customers = customers.size();
+        report.threads = pool.threadCount();
+        if (skus.empty()) return report;
+
+        // Arrivals are a Poisson process: exponential gaps between customers
+        std::mt19937_64 arrivals(config.seed);
+        std::exponential_distribution<double> gap(config.arrivalsPerSecond > 0 ? config.arrivalsPerSecond : 1.0);
+        trading.store(true);
+        std::thread auditor;
+        if (config.stock == StockStore::Versioned) {
+            auditor = std::thread([this] { audit(); });
+        }
+        Clock::time_point start = Clock::now();
+        Clock::time_point next = start;
+        for (auto& customer : customers) {
+            if (config.arrivalsPerSecond > 0) {
+                next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(gap(arrivals)));
+                std::this_thread::sleep_until(next);
+            }
+            Customer* c = customer.get();
+            c->arrived = Clock::now();
+            pool.submit([this, c] { shop(*c); });
+        }
+        pool.waitIdle();
+        report.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        trading.store(false, std::memory_order_release);
+        if (auditor.joinable()) auditor.join();
+        transactions.flush();
+
+        report.unitsSold = unitsSold.load();
+        countStock(report);
+        report.audits = audits;
+        report.auditMismatches = auditMismatches;
+
+        report.checkouts = checkouts.load();
+        report.itemsRejected = rejected.load();
+        report.checkoutsPerSecond = report.seconds > 0 ? report.checkouts / report.seconds : 0.0;
+        report.steals = pool.stealCount();
+
+        std::vector<double> sorted = latencyMicros;
+        std::sort(sorted.begin(), sorted.end());
+        auto percentile = [&sorted](double p) {
+            if (sorted.empty()) return 0.0;
+            size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+            return sorted[std::min(sorted.size() - 1, rank == 0 ? 0 : rank - 1)];
+        };
+        report.p50Micros = percentile(0.50);
+        report.p99Micros = percentile(0.99);
+        report.p999Micros = percentile(0.999);
+
+        for (const auto& lane : lanes) {
+            report.lanes.push_back(LaneReport{lane->served, lane->maxQueue,
+                                              lane->joins ? double(lane->queueSum) / lane->joins : 0.0});
+        }
+        return report;
+    }
+};
+
+} // namespace
+
+SimulationReport runCheckoutSimulation(const AVLTree& catalog, const SimulationConfig& config) {
+    std::error_code ec;
+    std::filesystem::remove(config.logFile, ec); // each run starts a fresh journal
+    Simulation simulation(catalog, config);
+    return simulation.run();
+}
+
+void printSimulationReport(const SimulationReport& report) {
+    std::cout << "\n===== Checkout Simulation =====" << std::endl;
+    std::cout << "Customers: " << report.customers << ", checkouts: " << report.checkouts
+              << ", items out of stock: " << report.itemsRejected << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Units sold: " << report.unitsSold << ", left on hand: " << report.unitsOnHand
+              << " worth $" << report.valueOnHand << std::endl;
+    if (report.audits > 0) {
+        std::cout << "Stock audits during trading: " << report.audits << " ("
+                  << report.auditMismatches << " inconsistent)" << std::endl;
+    }
+    std::cout << "Threads: " << report.threads << ", steals: " << report.steals << std::endl;
+    std::cout << "Elapsed: " << report.seconds << " s, throughput: "
+              << report.checkoutsPerSecond << " checkouts/s" << std::endl;
+    std::cout << "Checkout latency (arrival to paid): p50 " << report.p50Micros
+              << " us, p99 " << report.p99Micros << " us, p99.9 " << report.p999Micros << " us" << std::endl;
+    for (size_t i = 0; i < report.lanes.size(); ++i) {
+        const LaneReport& lane = report.lanes[i];
+        std::cout << "Lane " << i + 1 << ": served " << lane.served << ", mean queue "
+                  << lane.meanQueue << ", max queue " << lane.maxQueue << std::endl;
+    }
+    std::cout << "===============================" << std::endl;
+}
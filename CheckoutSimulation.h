@@ -0,0 +1,85 @@
+// CheckoutSimulation.h - Many customers shopping and checking out at once
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef CHECKOUT_SIMULATION_H
+#define CHECKOUT_SIMULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Money.h"
+
+class AVLTree;
+
+// How many distinct items a simulated customer picks
+enum class BasketDistribution {
+    Fixed,     // always meanBasketSize
+    Uniform,   // 1 .. 2 * meanBasketSize - 1
+    Geometric  // many small baskets, a long tail of big ones
+};
+
+// Where the simulated store keeps its stock
+enum class StockStore {
+    Ledger,   // ConcurrentInventory: one atomic counter per SKU, fastest
+    Versioned // VersionedInventory: copy-on-write, audited from snapshots while lanes trade
+};
+
+struct SimulationConfig {
+    size_t customers;
+    size_t lanes;
+    size_t threads;             // 0 = one per hardware thread
+    double arrivalsPerSecond;   // 0 = everyone arrives at once
+    BasketDistribution basket;
+    size_t meanBasketSize;
+    int stockPerItem;           // starting stock of every SKU; 0 keeps the catalog's
+    StockStore stock;
+    uint64_t seed;
+    std::string logFile;        // journal for the simulated transactions (replaced)
+
+    SimulationConfig()
+        : customers(10000), lanes(8), threads(0), arrivalsPerSecond(0.0),
+          basket(BasketDistribution::Geometric), meanBasketSize(12),
+          stockPerItem(1000000), stock(StockStore::Ledger), seed(307), logFile("simulation.log") {}
+};
+
+struct LaneReport {
+    size_t served;
+    size_t maxQueue;     // longest line seen when a customer joined
+    double meanQueue;    // average line length a joining customer found
+};
+
+struct SimulationReport {
+    size_t customers;
+    size_t checkouts;        // non-empty carts paid for
+    size_t itemsRejected;    // picks that failed (out of stock)
+    double seconds;
+    double checkoutsPerSecond;
+    // Arrival to paid, in microseconds (includes shopping and queueing)
+    double p50Micros;
+    double p99Micros;
+    double p999Micros;
+    int64_t unitsSold;
+    int64_t unitsOnHand;     // stock left after the last checkout
+    Money valueOnHand;
+    // Valuations taken from snapshots while lanes were trading (Versioned
+    // only), and how many of them did not add up to their own totals
+    size_t audits;
+    size_t auditMismatches;
+    uint64_t steals;
+    size_t threads;
+    std::vector<LaneReport> lanes;
+};
+
+// Copies the catalog into a thread-safe inventory and runs every customer
+// through the real ShoppingCart, CheckoutEngine and TransactionManager
+// paths on a shared work-stealing pool. Each customer shops as one task,
+// then joins the shortest lane; a lane is served by whichever worker
+// picks up its service task, one customer at a time. With
+// StockStore::Versioned an auditor thread values the stock from snapshots
+// the whole time. The catalog passed in is only read.
+SimulationReport runCheckoutSimulation(const AVLTree& catalog, const SimulationConfig& config);
+
+void printSimulationReport(const SimulationReport& report);
+
+#endif // CHECKOUT_SIMULATION_H
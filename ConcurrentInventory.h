@@ -0,0 +1,149 @@
+#ifndef CONCURRENT_INVENTORY_H
+#define CONCURRENT_INVENTORY_H
+
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include "AVLTree.h"
+#include "BPlusTree.h"
+#include "StockLedger.h"
+
+// Thread-safe inventory shared by every checkout lane and price-lookup kiosk.
+//
+// The catalog (tree shape, names, prices, aisles) is read-mostly and sits
+// in a BPlusTree, which answers point lookups two to three times faster
+// than AVLTree at every store size measured (bench index). It is behind
+// a reader/writer lock: lookups take it shared and never wait on each
+// other; only adding, replacing or removing an item takes it exclusively.
+// Stock levels are not kept in the tree at all but in a StockLedger of
+// atomic counters. Each catalog entry carries its SkuHandle, so a lane
+// resolves a UPC once and every later reserve/release on that SKU is a
+// single compare-and-swap on a 4-byte counter: two lanes can never both take
+// the last unit.
+class ConcurrentInventory {
+private:
+    mutable std::shared_mutex catalogLock;
+    BPlusTree tree;
+    StockLedger stock;
+
+public:
+    ConcurrentInventory() {}
+
+    ConcurrentInventory(const ConcurrentInventory&) = delete;
+    ConcurrentInventory& operator=(const ConcurrentInventory&) = delete;
+
+    // Create operation - Insert a grocery item
+    void insert(const GroceryItem& item) {
+        std::unique_lock<std::shared_mutex> lock(catalogLock);
+        if (!item.getUpc().isValid() || tree.search(item.getUpc()) != nullptr) {
+            return; // Duplicate UPC codes not allowed
+        }
+        SkuHandle sku = stock.allocate(item.getQuantity());
+        if (sku == kNoSku) {
+            return; // Ledger full, or a negative quantity
+        }
+        GroceryItem entry = item;
+        entry.setSku(sku);
+        tree.insert(entry);
+    }
+
+    // Read operation - Copy an item with its current stock level
+    bool lookup(UpcKey upcCode, GroceryItem& out) const {
+        std::shared_lock<std::shared_mutex> lock(catalogLock);
+        const GroceryItem* item = tree.search(upcCode);
+        if (item == nullptr) {
+            return false;
+        }
+        out = *item;
+        out.setQuantity(stock.get(item->getSku()));
+        return true;
+    }
+
+    // Resolve a UPC to the handle of its stock counter (kNoSku if unknown)
+    SkuHandle resolve(UpcKey upcCode) const {
+        std::shared_lock<std::shared_mutex> lock(catalogLock);
+        const GroceryItem* item = tree.search(upcCode);
+        return item == nullptr ? kNoSku : item->getSku();
+    }
+
+    // Update operation - Replace an item, including its stock level, which
+    // must not be negative
+    bool update(UpcKey upcCode, const GroceryItem& newItem) {
+        if (newItem.getQuantity() < 0) {
+            return false;
+        }
+        std::unique_lock<std::shared_mutex> lock(catalogLock);
+        GroceryItem* item = tree.search(upcCode);
+        if (item == nullptr) {
+            return false;
+        }
+        SkuHandle sku = item->getSku();
+        *item = newItem;
+        item->setUpc(upcCode); // the key cannot move within the tree
+        item->setSku(sku);
+        stock.set(sku, newItem.getQuantity());
+        return true;
+    }
+
+    // Delete operation - Remove an item by UPC code
+    bool remove(UpcKey upcCode) {
+        std::unique_lock<std::shared_mutex> lock(catalogLock);
+        const GroceryItem* item = tree.search(upcCode);
+        if (item == nullptr) {
+            return false;
+        }
+        stock.retire(item->getSku());
+        return tree.remove(upcCode);
+    }
+
+    // Hot path: take n units of an already-resolved SKU. Lock-free.
+    bool tryReserve(SkuHandle sku, int n) {
+        return sku != kNoSku && stock.tryReserve(sku, n);
+    }
+
+    // Hot path: give n units of an already-resolved SKU back. Lock-free.
+    bool release(SkuHandle sku, int n) {
+        return sku != kNoSku && stock.release(sku, n);
+    }
+
+    int stockLevel(SkuHandle sku) const {
+        return sku == kNoSku ? 0 : stock.get(sku);
+    }
+
+    // Resolve and reserve in one call. Whenever the item exists, snapshot
+    // receives its catalog entry (SkuHandle included) and the stock level
+    // seen before any units were taken.
+    StockStatus reserveStock(UpcKey upcCode, int quantity, GroceryItem& snapshot) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        std::shared_lock<std::shared_mutex> lock(catalogLock);
+        const GroceryItem* item = tree.search(upcCode);
+        if (item == nullptr) return StockStatus::NotFound;
+
+        snapshot = *item;
+        snapshot.setQuantity(stock.get(item->getSku()));
+        if (!stock.tryReserve(item->getSku(), quantity)) return StockStatus::InsufficientStock;
+        return StockStatus::Ok;
+    }
+
+    // Put quantity units back into stock
+    StockStatus releaseStock(UpcKey upcCode, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        std::shared_lock<std::shared_mutex> lock(catalogLock);
+        const GroceryItem* item = tree.search(upcCode);
+        if (item == nullptr) return StockStatus::NotFound;
+        stock.release(item->getSku(), quantity);
+        return StockStatus::Ok;
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> lock(catalogLock);
+        return tree.size();
+    }
+
+    bool isEmpty() const {
+        std::shared_lock<std::shared_mutex> lock(catalogLock);
+        return tree.isEmpty();
+    }
+};
+
+#endif
@@ -0,0 +1,94 @@
+// EventCalendar.h - Pending-event set for the discrete-event simulation
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef EVENT_CALENDAR_H
+#define EVENT_CALENDAR_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// One scheduled event. time is virtual microseconds; seq is the order the
+// event was scheduled in and breaks ties, so two runs with the same inputs
+// process simultaneous events in the same order.
+struct SimEvent {
+    int64_t time;
+    uint64_t seq;
+    uint32_t type;
+    uint32_t subject; // customer, lane or SKU slot, depending on type
+};
+
+// Min-priority queue of events keyed on (time, seq), stored as an
+// implicit 4-ary heap in one vector. A node's four children sit next to
+// each other (96 bytes), so a pop walks half as many levels as a binary
+// heap at the cost of a few extra compares per level.
+class EventCalendar {
+private:
+    static constexpr size_t kArity = 4;
+
+    std::vector<SimEvent> heap;
+    uint64_t nextSeq;
+
+    static bool before(const SimEvent& a, const SimEvent& b) {
+        return a.time < b.time || (a.time == b.time && a.seq < b.seq);
+    }
+
+    void siftUp(size_t i) {
+        SimEvent moving = heap[i];
+        while (i > 0) {
+            size_t parent = (i - 1) / kArity;
+            if (!before(moving, heap[parent])) break;
+            heap[i] = heap[parent];
+            i = parent;
+        }
+        heap[i] = moving;
+    }
+
+    void siftDown(size_t i) {
+        SimEvent moving = heap[i];
+        size_t count = heap.size();
+        while (true) {
+            size_t first = i * kArity + 1;
+            if (first >= count) break;
+            size_t last = first + kArity < count ? first + kArity : count;
+            size_t best = first;
+            for (size_t c = first + 1; c < last; ++c) {
+                if (before(heap[c], heap[best])) best = c;
+            }
+            if (!before(heap[best], moving)) break;
+            heap[i] = heap[best];
+            i = best;
+        }
+        heap[i] = moving;
+    }
+
+public:
+    EventCalendar() : nextSeq(0) {}
+
+    void reserve(size_t events) { heap.reserve(events); }
+
+    void schedule(int64_t time, uint32_t type, uint32_t subject) {
+        heap.push_back(SimEvent{time, nextSeq++, type, subject});
+        siftUp(heap.size() - 1);
+    }
+
+    // Remove and return the earliest event; the calendar must not be empty
+    SimEvent pop() {
+        SimEvent top = heap.front();
+        heap.front() = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) siftDown(0);
+        return top;
+    }
+
+    const SimEvent& peek() const { return heap.front(); }
+    bool empty() const { return heap.empty(); }
+    size_t size() const { return heap.size(); }
+
+    void clear() {
+        heap.clear();
+        nextSeq = 0;
+    }
+};
+
+#endif // EVENT_CALENDAR_H
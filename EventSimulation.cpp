@@ -0,0 +1,259 @@
+// EventSimulation.cpp - Discrete-event store model
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "EventSimulation.h"
+#include "AVLTree.h"
+#include "CheckoutEngine.h"
+#include "EventCalendar.h"
+#include "ShoppingCart.h"
+#include "TransactionProcessing.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr int64_t kMicrosPerSecond = 1000000;
+
+struct Shopper {
+    ShoppingCart cart;
+    uint32_t picksLeft;
+    int64_t joinedAt;
+};
+
+struct Checkstand {
+    std::deque<uint32_t> line; // shoppers waiting, not counting the one at the belt
+    bool busy;
+    uint32_t current;          // shopper being served while busy
+    size_t nextLine;           // cart line the cashier scans next
+};
+
+class StoreModel {
+private:
+    AVLTree& inventory;
+    const EventSimConfig& config;
+    EventCalendar calendar;
+    std::mt19937_64 rng;
+
+    std::vector<GroceryItem*> skus; // the model never inserts or removes, so these stay put
+    std::vector<bool> restockPending;
+    std::vector<Shopper> shoppers;   // slots are reused once a shopper leaves
+    std::vector<uint32_t> freeShoppers;
+    size_t shoppersInStore;
+    std::vector<Checkstand> lanes;
+
+    CheckoutEngine engine;
+    TransactionLogSink log;
+
+    int64_t closingTime;
+    int64_t meanArrivalGap;
+    int64_t meanPickTime;
+    int64_t scanTimePerUnit;
+    int64_t payTime;
+    int64_t restockLead;
+
+    EventSimReport report;
+    int64_t totalWait;
+    uint64_t digest;
+
+    // Exponentially distributed duration with the given mean, at least 1us
+    int64_t exponential(int64_t mean) {
+        double u = std::generate_canonical<double, 53>(rng);
+        int64_t value = static_cast<int64_t>(-std::log1p(-u) * static_cast<double>(mean));
+        return value > 0 ? value : 1;
+    }
+
+    uint32_t basketSize() {
+        double p = 1.0 / static_cast<double>(std::max<size_t>(config.meanBasketSize, 1));
+        double u = std::generate_canonical<double, 53>(rng);
+        return 1 + static_cast<uint32_t>(std::log1p(-u) / std::log1p(-p));
+    }
+
+    // Popular items get picked more: squaring a uniform draw puts
+    // about 30% of picks in the first tenth of the catalog
+    size_t pickSku() {
+        double u = std::generate_canonical<double, 53>(rng);
+        return std::min(skus.size() - 1, static_cast<size_t>(u * u * static_cast<double>(skus.size())));
+    }
+
+    void schedule(int64_t time, SimEventType type, uint32_t subject) {
+        calendar.schedule(time, static_cast<uint32_t>(type), subject);
+    }
+
+    void arrival(int64_t now) {
+        if (now >= closingTime) return;
+        uint32_t id;
+        if (freeShoppers.empty()) {
+            id = static_cast<uint32_t>(shoppers.size());
+            shoppers.emplace_back();
+        } else {
+            id = freeShoppers.back();
+            freeShoppers.pop_back();
+        }
+        shoppers[id].picksLeft = basketSize();
+        shoppersInStore++;
+        report.customers++;
+        schedule(now + exponential(meanPickTime), SimEventType::ItemPick, id);
+        schedule(now + exponential(meanArrivalGap), SimEventType::Arrival, 0);
+    }
+
+    void itemPick(int64_t now, uint32_t id) {
+        Shopper& shopper = shoppers[id];
+        size_t sku = pickSku();
+        int quantity = 1 + static_cast<int>(rng() % 3);
+        if (shopper.cart.tryAddItem(inventory, *skus[sku], quantity) != StockStatus::Ok) {
+            report.rejectedPicks++;
+            if (!restockPending[sku]) {
+                restockPending[sku] = true;
+                schedule(now + restockLead, SimEventType::Restock, static_cast<uint32_t>(sku));
+            }
+        }
+        if (--shopper.picksLeft > 0) {
+            schedule(now + exponential(meanPickTime), SimEventType::ItemPick, id);
+        } else {
+            schedule(now, SimEventType::LaneJoin, id);
+        }
+    }
+
+    void laneJoin(int64_t now, uint32_t id) {
+        Shopper& shopper = shoppers[id];
+        if (shopper.cart.isEmpty()) {
+            leave(id); // found nothing in stock
+            return;
+        }
+        size_t best = 0;
+        for (size_t i = 1; i < lanes.size(); ++i) {
+            if (lanes[i].line.size() + lanes[i].busy < lanes[best].line.size() + lanes[best].busy) best = i;
+        }
+        Checkstand& lane = lanes[best];
+        shopper.joinedAt = now;
+        lane.line.push_back(id);
+        report.maxQueue = std::max(report.maxQueue, lane.line.size());
+        if (!lane.busy) startNext(now, static_cast<uint32_t>(best));
+    }
+
+    // Bring the next shopper in line to the belt
+    void startNext(int64_t now, uint32_t laneId) {
+        Checkstand& lane = lanes[laneId];
+        if (lane.line.empty()) {
+            lane.busy = false;
+            return;
+        }
+        lane.busy = true;
+        lane.current = lane.line.front();
+        lane.line.pop_front();
+        lane.nextLine = 0;
+        totalWait += now - shoppers[lane.current].joinedAt;
+        schedule(now, SimEventType::Scan, laneId);
+    }
+
+    void scan(int64_t now, uint32_t laneId) {
+        Checkstand& lane = lanes[laneId];
+        const std::vector<CartLine>& lines = shoppers[lane.current].cart.getLines();
+        int64_t duration = lines[lane.nextLine].quantity * scanTimePerUnit;
+        if (++lane.nextLine < lines.size()) {
+            schedule(now + duration, SimEventType::Scan, laneId);
+        } else {
+            schedule(now + duration + payTime, SimEventType::Pay, laneId);
+        }
+    }
+
+    void pay(int64_t now, uint32_t laneId) {
+        Checkstand& lane = lanes[laneId];
+        const Receipt& receipt = engine.checkout(shoppers[lane.current].cart);
+        report.revenue += receipt.total;
+        report.checkouts++;
+        leave(lane.current);
+        startNext(now, laneId);
+    }
+
+    void restock(uint32_t sku) {
+        inventory.releaseStock(skus[sku]->getUpc(), config.restockQuantity);
+        restockPending[sku] = false;
+        report.restocks++;
+    }
+
+    void leave(uint32_t id) {
+        shoppers[id].cart.clearCart();
+        freeShoppers.push_back(id);
+        shoppersInStore--;
+    }
+
+    // FNV-1a over the event's fields
+    void fold(const SimEvent& event) {
+        uint64_t words[3] = {static_cast<uint64_t>(event.time), event.type, event.subject};
+        for (uint64_t word : words) {
+            digest ^= word;
+            digest *= 0x100000001B3ull;
+        }
+    }
+
+public:
+    StoreModel(AVLTree& inventory, TransactionManager& transactions, const EventSimConfig& config)
+        : inventory(inventory), config(config), rng(config.seed),
+          shoppersInStore(0), log(transactions, inventory), report{}, totalWait(0), digest(0xCBF29CE484222325ull) {
+        inventory.forEachItem([this, &inventory](const GroceryItem& item) {
+            skus.push_back(inventory.search(item.getUpc()));
+        });
+        restockPending.assign(skus.size(), false);
+        lanes.assign(std::max<size_t>(config.lanes, 1), Checkstand{std::deque<uint32_t>(), false, 0, 0});
+        engine.addSink(&log);
+
+        auto micros = [](double seconds) { return static_cast<int64_t>(seconds * kMicrosPerSecond); };
+        closingTime = micros(config.hours * 3600.0);
+        meanArrivalGap = micros(3600.0 / std::max(config.arrivalsPerHour, 1e-9));
+        meanPickTime = micros(config.meanPickSeconds);
+        scanTimePerUnit = micros(config.scanSecondsPerUnit);
+        payTime = micros(config.paySeconds);
+        restockLead = micros(config.restockLeadMinutes * 60.0);
+        calendar.reserve(1024);
+    }
+
+    EventSimReport run() {
+        auto started = std::chrono::steady_clock::now();
+        int64_t now = 0;
+        if (!skus.empty() && config.arrivalsPerHour > 0) {
+            schedule(exponential(meanArrivalGap), SimEventType::Arrival, 0);
+        }
+        while (!calendar.empty()) {
+            SimEvent event = calendar.pop();
+            // Once the doors are shut and the last shopper has left, only
+            // deliveries remain and they change nothing worth reporting
+            if (event.time >= closingTime && shoppersInStore == 0 &&
+                event.type == static_cast<uint32_t>(SimEventType::Restock)) {
+                break;
+            }
+            now = event.time;
+            report.events++;
+            fold(event);
+            switch (static_cast<SimEventType>(event.type)) {
+            case SimEventType::Arrival:  arrival(now); break;
+            case SimEventType::ItemPick: itemPick(now, event.subject); break;
+            case SimEventType::LaneJoin: laneJoin(now, event.subject); break;
+            case SimEventType::Scan:     scan(now, event.subject); break;
+            case SimEventType::Pay:      pay(now, event.subject); break;
+            case SimEventType::Restock:  restock(event.subject); break;
+            }
+        }
+        report.wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        report.eventsPerSecond = report.wallSeconds > 0 ? report.events / report.wallSeconds : 0.0;
+        report.simulatedHours = static_cast<double>(now) / (3600.0 * kMicrosPerSecond);
+        report.meanWaitMinutes = report.checkouts
+                                     ? static_cast<double>(totalWait) / report.checkouts / (60.0 * kMicrosPerSecond)
+                                     : 0.0;
+        digest ^= static_cast<uint64_t>(report.revenue.getCents());
+        report.digest = digest * 0x100000001B3ull;
+        return report;
+    }
+};
+
+} // namespace
+
+EventSimReport runEventSimulation(AVLTree& inventory, TransactionManager& transactions,
+                                  const EventSimConfig& config) {
+    StoreModel model(inventory, transactions, config);
+    return model.run();
+}
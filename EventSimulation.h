@@ -0,0 +1,65 @@
+// EventSimulation.h - Discrete-event model of a store day in virtual time
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef EVENT_SIMULATION_H
+#define EVENT_SIMULATION_H
+
+#include <cstddef>
+#include <cstdint>
+#include "Money.h"
+
+class AVLTree;
+class TransactionManager;
+
+// Kinds of event on the calendar
+enum class SimEventType : uint32_t {
+    Arrival,  // a customer walks in (subject unused)
+    ItemPick, // a shopper takes the next item off a shelf (subject = shopper)
+    LaneJoin, // a shopper with a full basket picks a lane (subject = shopper)
+    Scan,     // the cashier scans the next cart line (subject = lane)
+    Pay,      // the customer at the head of the lane pays (subject = lane)
+    Restock   // a delivery for one SKU arrives (subject = SKU slot)
+};
+
+struct EventSimConfig {
+    double hours;               // how long the doors are open; shoppers inside still finish
+    double arrivalsPerHour;     // Poisson arrivals
+    size_t lanes;
+    size_t meanBasketSize;      // geometric around this mean
+    double meanPickSeconds;     // walking time between items
+    double scanSecondsPerUnit;
+    double paySeconds;
+    double restockLeadMinutes;  // from the first failed pick to the delivery
+    int restockQuantity;        // units delivered per restock
+    uint64_t seed;
+
+    EventSimConfig()
+        : hours(12.0), arrivalsPerHour(300.0), lanes(8), meanBasketSize(12),
+          meanPickSeconds(40.0), scanSecondsPerUnit(2.0), paySeconds(30.0),
+          restockLeadMinutes(90.0), restockQuantity(200), seed(307) {}
+};
+
+struct EventSimReport {
+    uint64_t events;
+    uint64_t customers;
+    uint64_t checkouts;      // non-empty carts paid for
+    uint64_t rejectedPicks;  // item out of stock when picked
+    uint64_t restocks;
+    Money revenue;
+    double simulatedHours;   // until the last shopper left
+    double meanWaitMinutes;  // lane join to start of scanning
+    size_t maxQueue;
+    double wallSeconds;
+    double eventsPerSecond;
+    uint64_t digest;         // hash of every processed event; equal for equal runs
+};
+
+// Run the store in virtual time. Shoppers take stock from inventory
+// through ShoppingCart, pay through CheckoutEngine, and every sale is
+// recorded with transactions. All randomness comes from config.seed and
+// simultaneous events run in the order they were scheduled, so the same
+// seed, catalog and config always give the same digest.
+EventSimReport runEventSimulation(AVLTree& inventory, TransactionManager& transactions,
+                                  const EventSimConfig& config);
+
+#endif // EVENT_SIMULATION_H
@@ -2,36 +2,61 @@
 #define GROCERY_ITEM_H
 
 #include <string>
+#include <string_view>
+#include <cstdint>
+#include "UpcKey.h"
+#include "Money.h"
+#include "StringInterner.h"
 
+// Slot of an item's stock counter in a StockLedger (kNoSku when not tracked)
+using SkuHandle = uint32_t;
+constexpr SkuHandle kNoSku = 0xFFFFFFFFu;
+
+// Name and aisle are handles into StringInterner::global(), so copying an
+// item copies no text
 class GroceryItem {
 private:
-    std::string name;
-    std::string upcCode;
-    double price;
+    InternedString name;
+    UpcKey upc;
+    Money price;
     int quantity;
-    std::string aisle;
+    InternedString aisle;
+    SkuHandle sku;
 
 public:
     // Constructors
-    GroceryItem() : name(""), upcCode(""), price(0.0), quantity(0), aisle("") {}
+    GroceryItem() : name(), upc(), price(), quantity(0), aisle(), sku(kNoSku) {}
+    
+    GroceryItem(std::string_view name, const std::string& upcCode, Money price, 
+                int quantity, std::string_view aisle)
+        : name(name), upc(UpcKey::fromString(upcCode)), price(price), quantity(quantity), aisle(aisle), sku(kNoSku) {}
+    
+    GroceryItem(std::string_view name, UpcKey upc, Money price, 
+                int quantity, std::string_view aisle)
+        : name(name), upc(upc), price(price), quantity(quantity), aisle(aisle), sku(kNoSku) {}
     
-    GroceryItem(const std::string& name, const std::string& upcCode, double price, 
-                int quantity, const std::string& aisle)
-        : name(name), upcCode(upcCode), price(price), quantity(quantity), aisle(aisle) {}
+    GroceryItem(InternedString name, UpcKey upc, Money price, int quantity, InternedString aisle)
+        : name(name), upc(upc), price(price), quantity(quantity), aisle(aisle), sku(kNoSku) {}
     
     // Getters
-    std::string getName() const { return name; }
-    std::string getUpcCode() const { return upcCode; }
-    double getPrice() const { return price; }
+    std::string_view getName() const { return name.view(); }
+    std::string getUpcCode() const { return upc.toString(); } // formats the key; prefer getUpc()
+    UpcKey getUpc() const { return upc; }
+    Money getPrice() const { return price; }
     int getQuantity() const { return quantity; }
-    std::string getAisle() const { return aisle; }
+    std::string_view getAisle() const { return aisle.view(); }
+    InternedString getNameHandle() const { return name; }
+    InternedString getAisleHandle() const { return aisle; }
+    SkuHandle getSku() const { return sku; }
     
     // Setters
-    void setName(const std::string& newName) { name = newName; }
-    void setUpcCode(const std::string& newUpc) { upcCode = newUpc; }
-    void setPrice(double newPrice) { price = newPrice; }
+    void setName(std::string_view newName) { name = InternedString(newName); }
+    void setUpcCode(const std::string& newUpc) { upc = UpcKey::fromString(newUpc); }
+    void setUpc(UpcKey newUpc) { upc = newUpc; }
+    void setPrice(Money newPrice) { price = newPrice; }
     void setQuantity(int newQuantity) { quantity = newQuantity; }
-    void setAisle(const std::string& newAisle) { aisle = newAisle; }
+    void setAisle(std::string_view newAisle) { aisle = InternedString(newAisle); }
+    void setSku(SkuHandle newSku) { sku = newSku; }
 };
 
 #endif 
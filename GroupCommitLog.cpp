@@ -0,0 +1,128 @@
+// GroupCommitLog.cpp - Implementation of the batching journal writer
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "GroupCommitLog.h"
+#include <iostream>
+
+GroupCommitLog::GroupCommitLog()
+    : journal(nullptr), head(0), tail(0), syncedUpTo(0), flushTarget(0),
+      stopping(false), failed(false) {
+}
+
+GroupCommitLog::~GroupCommitLog() {
+    stop();
+}
+
+void GroupCommitLog::start(JournalWriter* target, const GroupCommitOptions& opts) {
+    stop();
+
+    journal = target;
+    options = opts;
+    if (options.queueCapacity == 0) options.queueCapacity = 1;
+    if (options.batchSize == 0) options.batchSize = 1;
+
+    ring.assign(options.queueCapacity, std::vector<unsigned char>());
+    head = tail = syncedUpTo = flushTarget = 0;
+    stopping = false;
+    failed = false;
+    writer = std::thread(&GroupCommitLog::writerLoop, this);
+}
+
+// Caller holds the lock
+bool GroupCommitLog::workPending(std::chrono::steady_clock::time_point now) const {
+    bool syncRequested = flushTarget > syncedUpTo;
+    if (tail == head) return syncRequested;
+    if (stopping || syncRequested) return true;
+    if (options.policy == DurabilityPolicy::PerTransaction) return true;
+    if (tail - head >= options.batchSize) return true;
+    return now - oldestQueuedAt >= options.interval;
+}
+
+void GroupCommitLog::writerLoop() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        while (!workPending(std::chrono::steady_clock::now())) {
+            if (stopping) return;
+            if (tail == head) {
+                workReady.wait(guard);
+            } else {
+                workReady.wait_until(guard, oldestQueuedAt + options.interval);
+            }
+        }
+
+        // Slots [head, end) are ours until head moves; producers only fill
+        // slots past tail, so the batch can be written without the lock.
+        uint64_t begin = head;
+        uint64_t end = tail;
+        bool syncNow = options.policy != DurabilityPolicy::Async || flushTarget > syncedUpTo;
+        guard.unlock();
+
+        bool ok = true;
+        for (uint64_t seq = begin; seq < end && ok; ++seq) {
+            ok = journal->append(ring[seq % ring.size()]);
+        }
+        ok = ok && (syncNow ? journal->sync() : journal->flush());
+
+        guard.lock();
+        if (!ok && !failed) {
+            failed = true;
+            std::cerr << "Error: Could not write to transaction log file.\n";
+        }
+        head = end;
+        if (syncNow) {
+            syncedUpTo = end;
+        }
+        if (head != tail) {
+            oldestQueuedAt = std::chrono::steady_clock::now();
+        }
+        spaceFree.notify_all();
+        progress.notify_all();
+    }
+}
+
+bool GroupCommitLog::submit(const unsigned char* payload, size_t length) {
+    std::unique_lock<std::mutex> guard(lock);
+    if (!writer.joinable() || stopping || failed) return false;
+
+    spaceFree.wait(guard, [this] { return tail - head < ring.size() || failed; });
+    if (failed) return false;
+
+    uint64_t seq = tail++;
+    ring[seq % ring.size()].assign(payload, payload + length);
+    if (seq == head) {
+        oldestQueuedAt = std::chrono::steady_clock::now();
+    }
+    // The writer sleeps until the batch fills or the interval runs out, so
+    // only wake it when this record changes which of those comes first
+    if (seq == head || tail - head >= options.batchSize ||
+        options.policy == DurabilityPolicy::PerTransaction) {
+        workReady.notify_one();
+    }
+
+    if (options.policy == DurabilityPolicy::PerTransaction) {
+        progress.wait(guard, [this, seq] { return syncedUpTo > seq || failed; });
+    }
+    return !failed;
+}
+
+bool GroupCommitLog::flush() {
+    std::unique_lock<std::mutex> guard(lock);
+    if (!writer.joinable()) return !failed;
+
+    uint64_t target = tail;
+    if (target > flushTarget) flushTarget = target;
+    workReady.notify_one();
+    progress.wait(guard, [this, target] { return syncedUpTo >= target || failed; });
+    return !failed;
+}
+
+void GroupCommitLog::stop() {
+    if (!writer.joinable()) return;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stopping = true;
+        flushTarget = tail; // everything queued is written and synced first
+    }
+    workReady.notify_one();
+    writer.join();
+}
@@ -0,0 +1,89 @@
+// GroupCommitLog.h - Background writer that batches journal records
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef GROUP_COMMIT_LOG_H
+#define GROUP_COMMIT_LOG_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "TransactionJournal.h"
+
+// How long a checkout waits for its record to reach the disk
+enum class DurabilityPolicy {
+    PerTransaction, // submit() returns once the record is fdatasync'ed
+    GroupCommit,    // records are synced in batches; submit() does not wait
+    Async           // records are written in batches but only synced by flush()
+};
+
+struct GroupCommitOptions {
+    DurabilityPolicy policy;
+    size_t queueCapacity;               // records buffered before submit() blocks
+    size_t batchSize;                   // write as soon as this many are pending
+    std::chrono::milliseconds interval; // ...or once the oldest has waited this long
+
+    GroupCommitOptions()
+        : policy(DurabilityPolicy::GroupCommit), queueCapacity(4096),
+          batchSize(256), interval(5) {}
+};
+
+// Owns a writer thread that drains a bounded queue of encoded records into
+// a JournalWriter, issuing one sync per batch. Producers copy their record
+// into a preallocated ring slot, so a steady-state submit() does not
+// allocate and never touches the disk itself.
+class GroupCommitLog {
+private:
+    JournalWriter* journal;
+    GroupCommitOptions options;
+
+    std::vector<std::vector<unsigned char>> ring;
+    uint64_t head;      // sequence number of the oldest queued record
+    uint64_t tail;      // sequence number the next submit() will get
+    uint64_t syncedUpTo;  // records below this have been synced to disk
+    uint64_t flushTarget; // flush() asks for a sync of everything below this
+    std::chrono::steady_clock::time_point oldestQueuedAt;
+    bool stopping;
+    bool failed;
+
+    std::mutex lock;
+    std::condition_variable workReady;
+    std::condition_variable spaceFree;
+    std::condition_variable progress;
+    std::thread writer;
+
+    void writerLoop();
+    bool workPending(std::chrono::steady_clock::time_point now) const;
+
+public:
+    GroupCommitLog();
+    ~GroupCommitLog();
+
+    GroupCommitLog(const GroupCommitLog&) = delete;
+    GroupCommitLog& operator=(const GroupCommitLog&) = delete;
+
+    // Start the writer thread on an already-open journal
+    void start(JournalWriter* target, const GroupCommitOptions& opts);
+
+    // Queue a record; blocks only while the queue is full, or, under
+    // PerTransaction, until the record is durable. Returns false if the
+    // log is not running or a write has failed.
+    bool submit(const unsigned char* payload, size_t length);
+    bool submit(const std::vector<unsigned char>& payload) {
+        return submit(payload.data(), payload.size());
+    }
+
+    // Barrier: returns once every record submitted so far is written and
+    // synced, whatever the policy
+    bool flush();
+
+    // flush() and stop the writer thread
+    void stop();
+
+    bool isRunning() const { return writer.joinable(); }
+    DurabilityPolicy policy() const { return options.policy; }
+};
+
+#endif // GROUP_COMMIT_LOG_H
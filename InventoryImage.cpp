@@ -0,0 +1,264 @@
+// InventoryImage.cpp - Writing, mapping and decoding inventory images
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "InventoryImage.h"
+#include "LoaderUtil.h"
+#include "TransactionJournal.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kImageMagic[4] = {'G', 'I', 'M', 'G'};
+constexpr size_t kHeaderCrcBytes = offsetof(ImageHeader, headerCrc);
+constexpr uint16_t kMaxTextLength = 0xFFFFu;
+
+// Interns strings into one pool. A string is identified by its (offset,
+// length) in the pool packed into 64 bits, and hashed and compared by its
+// text, so the set holds no copies of its own.
+class StringPool {
+private:
+    struct TextHash {
+        const std::string* pool;
+        size_t operator()(uint64_t key) const {
+            return std::hash<std::string_view>()(std::string_view(*pool).substr(key >> 16, key & 0xFFFFu));
+        }
+    };
+    struct TextEqual {
+        const std::string* pool;
+        bool operator()(uint64_t a, uint64_t b) const {
+            std::string_view all(*pool);
+            return all.substr(a >> 16, a & 0xFFFFu) == all.substr(b >> 16, b & 0xFFFFu);
+        }
+    };
+
+    std::string pool;
+    std::unordered_set<uint64_t, TextHash, TextEqual> seen;
+
+public:
+    StringPool() : seen(1024, TextHash{&pool}, TextEqual{&pool}) {}
+
+    // Offset of value in the pool, adding it if it is new. The candidate is
+    // appended first so it can be looked up in place, and cut off again if
+    // an equal string was already there.
+    uint32_t intern(std::string_view value, uint16_t& length) {
+        length = static_cast<uint16_t>(std::min<size_t>(value.size(), kMaxTextLength));
+        uint64_t offset = pool.size();
+        pool.append(value.data(), length);
+        auto found = seen.insert((offset << 16) | length);
+        if (!found.second) {
+            pool.resize(offset);
+        }
+        return static_cast<uint32_t>(*found.first >> 16);
+    }
+
+    const std::string& bytes() const { return pool; }
+};
+
+bool syncFile(std::FILE* file) {
+    if (std::fflush(file) != 0) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(file)) == 0;
+#else
+    return fdatasync(fileno(file)) == 0;
+#endif
+}
+
+} // namespace
+
+// InventoryImage
+
+InventoryImage::InventoryImage() : header(), records(nullptr), strings(nullptr) {
+}
+
+ImageStatus InventoryImage::open(const std::string& path) {
+    close();
+    if (!file.open(path)) {
+        return ImageStatus::Missing;
+    }
+    if (file.size() < sizeof(ImageHeader) || std::memcmp(file.data(), kImageMagic, 4) != 0) {
+        file.close();
+        return ImageStatus::WrongFormat;
+    }
+
+    ImageHeader candidate;
+    std::memcpy(&candidate, file.data(), sizeof candidate);
+    // Fields are read in host byte order, so on a big-endian host the
+    // version check fails here too
+    if (candidate.version != kFormatVersion || candidate.recordSize != sizeof(ImageRecord)) {
+        file.close();
+        return ImageStatus::WrongFormat;
+    }
+    uint64_t recordSpace = file.size() - sizeof(ImageHeader);
+    if (crc32(&candidate, kHeaderCrcBytes) != candidate.headerCrc ||
+        candidate.itemCount > recordSpace / sizeof(ImageRecord) ||
+        candidate.stringsOffset != sizeof(ImageHeader) + candidate.itemCount * sizeof(ImageRecord) ||
+        candidate.stringsSize > file.size() - candidate.stringsOffset) {
+        file.close();
+        return ImageStatus::Damaged;
+    }
+
+    header = candidate;
+    // The mapping is page-aligned and the header is 64 bytes, so the
+    // record array is suitably aligned to be used where it lies
+    records = reinterpret_cast<const ImageRecord*>(file.data() + sizeof(ImageHeader));
+    strings = reinterpret_cast<const char*>(file.data() + header.stringsOffset);
+    return ImageStatus::Ok;
+}
+
+void InventoryImage::close() {
+    file.close();
+    header = ImageHeader();
+    records = nullptr;
+    strings = nullptr;
+}
+
+// A string from the pool; empty if the record points outside it
+std::string_view InventoryImage::text(uint32_t offset, uint16_t length) const {
+    if (static_cast<uint64_t>(offset) + length > header.stringsSize) {
+        return std::string_view();
+    }
+    return std::string_view(strings + offset, length);
+}
+
+GroceryItem InventoryImage::itemAt(size_t i) const {
+    return GroceryItem(nameAt(i), upcAt(i), priceAt(i), quantityAt(i), aisleAt(i));
+}
+
+bool InventoryImage::find(UpcKey upcCode, GroceryItem& out) const {
+    size_t lo = 0;
+    size_t hi = size();
+    uint64_t key = upcCode.raw();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (records[mid].upc < key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == size() || records[lo].upc != key) {
+        return false;
+    }
+    out = itemAt(lo);
+    return true;
+}
+
+bool InventoryImage::verify() const {
+    if (!isOpen()) return false;
+    size_t bodySize = static_cast<size_t>(header.stringsOffset + header.stringsSize) - sizeof(ImageHeader);
+    return crc32(file.data() + sizeof(ImageHeader), bodySize) == header.bodyCrc;
+}
+
+bool InventoryImage::decode(std::vector<GroceryItem>& items) const {
+    items.clear();
+    if (!isOpen()) return false;
+    size_t count = size();
+    items.resize(count);
+
+    size_t parts = std::min(loaderThreadsFor(count * sizeof(ImageRecord)), std::max<size_t>(count, 1));
+    std::vector<char> ordered(parts, 1);
+    runParallel(parts, [&](size_t part) {
+        size_t begin = count * part / parts;
+        size_t end = count * (part + 1) / parts;
+        // The pool stores each aisle once, so its offset identifies it and
+        // only the first record of each aisle needs interning
+        std::unordered_map<uint32_t, InternedString> aisles;
+        for (size_t i = begin; i < end; ++i) {
+            // Each chunk also checks the boundary with the chunk before it
+            if (i > 0 && records[i - 1].upc >= records[i].upc) {
+                ordered[part] = 0;
+                return;
+            }
+            auto aisle = aisles.find(records[i].aisleOffset);
+            if (aisle == aisles.end()) {
+                aisle = aisles.emplace(records[i].aisleOffset, InternedString(aisleAt(i))).first;
+            }
+            items[i] = GroceryItem(InternedString(nameAt(i)), upcAt(i), priceAt(i), quantityAt(i), aisle->second);
+        }
+    });
+    for (char ok : ordered) {
+        if (!ok) {
+            items.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool InventoryImage::buildTree(AVLTree& inventory) const {
+    std::vector<GroceryItem> items;
+    if (!decode(items)) {
+        return false;
+    }
+    inventory.assignSorted(std::move(items));
+    return true;
+}
+
+// Writer
+
+bool writeInventoryImage(const std::string& path, const AVLTree& inventory, uint64_t lastSequence) {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    if (out == nullptr) {
+        return false;
+    }
+
+    // Header goes in last, once the sizes and checksum are known
+    ImageHeader header{};
+    bool ok = std::fwrite(&header, sizeof header, 1, out) == 1;
+
+    StringPool pool;
+    std::vector<ImageRecord> buffer;
+    buffer.reserve(4096);
+    uint32_t bodyCrc = 0;
+    uint64_t count = 0;
+    auto writeRecords = [&]() {
+        if (buffer.empty()) return;
+        bodyCrc = crc32(buffer.data(), buffer.size() * sizeof(ImageRecord), bodyCrc);
+        ok = ok && std::fwrite(buffer.data(), sizeof(ImageRecord), buffer.size(), out) == buffer.size();
+        buffer.clear();
+    };
+    inventory.forEachItem([&](const GroceryItem& item) {
+        ImageRecord record{};
+        record.upc = item.getUpc().raw();
+        record.priceCents = item.getPrice().getCents();
+        record.quantity = item.getQuantity();
+        record.nameOffset = pool.intern(item.getName(), record.nameLength);
+        record.aisleOffset = pool.intern(item.getAisle(), record.aisleLength);
+        buffer.push_back(record);
+        count++;
+        if (buffer.size() == buffer.capacity()) writeRecords();
+    });
+    writeRecords();
+
+    const std::string& text = pool.bytes();
+    ok = ok && text.size() <= 0xFFFFFFFFu; // offsets are 32-bit
+    bodyCrc = crc32(text.data(), text.size(), bodyCrc);
+    ok = ok && std::fwrite(text.data(), 1, text.size(), out) == text.size();
+
+    std::memcpy(header.magic, kImageMagic, 4);
+    header.version = InventoryImage::kFormatVersion;
+    header.itemCount = count;
+    header.stringsOffset = sizeof(ImageHeader) + count * sizeof(ImageRecord);
+    header.stringsSize = text.size();
+    header.lastSequence = lastSequence;
+    header.recordSize = sizeof(ImageRecord);
+    header.bodyCrc = bodyCrc;
+    header.headerCrc = crc32(&header, kHeaderCrcBytes);
+    ok = ok && std::fseek(out, 0, SEEK_SET) == 0 && std::fwrite(&header, sizeof header, 1, out) == 1;
+    ok = ok && syncFile(out);
+    return std::fclose(out) == 0 && ok;
+}
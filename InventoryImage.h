@@ -0,0 +1,113 @@
+// InventoryImage.h - Memory-mappable binary snapshot of the inventory
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef INVENTORY_IMAGE_H
+#define INVENTORY_IMAGE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "AVLTree.h"
+#include "GroceryItem.h"
+#include "MappedFile.h"
+
+// On-disk layout (little-endian, every section 8-byte aligned):
+//
+//   header  : 64 bytes, see ImageHeader
+//   records : itemCount fixed 32-byte ImageRecords, sorted by UPC
+//   strings : string pool; each distinct name or aisle is stored once and
+//             records point at it by offset and length
+//
+// The records are read in place from the mapping, so an image answers
+// lookups (a binary search over the record array) as soon as the header
+// has been checked, with nothing decoded up front.
+struct ImageHeader {
+    char magic[4];          // "GIMG"
+    uint32_t version;       // InventoryImage::kFormatVersion
+    uint64_t itemCount;
+    uint64_t stringsOffset; // records start right after the header
+    uint64_t stringsSize;
+    uint64_t lastSequence;  // inventory log record the image includes (0 if none)
+    uint32_t recordSize;    // sizeof(ImageRecord)
+    uint32_t bodyCrc;       // CRC-32 of the records and the string pool
+    uint64_t reserved;
+    uint32_t reserved2;
+    uint32_t headerCrc;     // CRC-32 of the 60 bytes before it
+};
+
+struct ImageRecord {
+    uint64_t upc;           // packed UpcKey
+    int64_t priceCents;
+    int32_t quantity;
+    uint32_t nameOffset;    // into the string pool
+    uint32_t aisleOffset;
+    uint16_t nameLength;
+    uint16_t aisleLength;
+};
+
+static_assert(sizeof(ImageHeader) == 64, "image header must stay 64 bytes");
+static_assert(sizeof(ImageRecord) == 32, "image records must stay 32 bytes");
+
+enum class ImageStatus {
+    Ok,
+    Missing,     // the file does not exist or cannot be mapped
+    WrongFormat, // not an inventory image (or another version / byte order)
+    Damaged      // an image whose header or layout does not check out
+};
+
+// Read-only view of an image file
+class InventoryImage {
+private:
+    MappedFile file;
+    ImageHeader header;
+    const ImageRecord* records;
+    const char* strings;
+
+    std::string_view text(uint32_t offset, uint16_t length) const;
+
+public:
+    static constexpr uint32_t kFormatVersion = 1;
+
+    InventoryImage();
+
+    InventoryImage(const InventoryImage&) = delete;
+    InventoryImage& operator=(const InventoryImage&) = delete;
+
+    // Map the file and check its header and section bounds; O(1) in the
+    // number of items. The body checksum is left to verify().
+    ImageStatus open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return records != nullptr; }
+    size_t size() const { return static_cast<size_t>(header.itemCount); }
+    uint64_t lastSequence() const { return header.lastSequence; }
+
+    // Binary search for upcCode; fills out and returns true if present
+    bool find(UpcKey upcCode, GroceryItem& out) const;
+
+    // Fields of the i-th record (UPC order)
+    UpcKey upcAt(size_t i) const { return UpcKey::fromRaw(records[i].upc); }
+    Money priceAt(size_t i) const { return Money::fromCents(records[i].priceCents); }
+    int quantityAt(size_t i) const { return records[i].quantity; }
+    std::string_view nameAt(size_t i) const { return text(records[i].nameOffset, records[i].nameLength); }
+    std::string_view aisleAt(size_t i) const { return text(records[i].aisleOffset, records[i].aisleLength); }
+    GroceryItem itemAt(size_t i) const;
+
+    // Check the body CRC; reads the whole file
+    bool verify() const;
+
+    // Decode every record, in parallel chunks, into items (UPC order).
+    // Returns false if the records are not in strictly ascending UPC order.
+    bool decode(std::vector<GroceryItem>& items) const;
+
+    // decode() straight into inventory's bottom-up bulk load
+    bool buildTree(AVLTree& inventory) const;
+};
+
+// Write inventory as an image, in UPC order, and sync it. Equal names and
+// aisles share one copy in the string pool.
+bool writeInventoryImage(const std::string& path, const AVLTree& inventory, uint64_t lastSequence = 0);
+
+#endif // INVENTORY_IMAGE_H
@@ -0,0 +1,387 @@
+// InventoryLog.cpp - Inventory write-ahead log, checkpoints and recovery
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "InventoryLog.h"
+#include "InventoryImage.h"
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+namespace {
+
+enum RecordType : uint8_t {
+    kInsert = 1,
+    kUpdate = 2,
+    kRemove = 3,
+    kStockChange = 4,
+    // Records of the older journal-format checkpoint
+    kCheckpointBegin = 16,
+    kCheckpointItems = 17,
+    kCheckpointEnd = 18
+};
+
+void putItem(ByteWriter& writer, const GroceryItem& item) {
+    writer.putU64(item.getUpc().raw());
+    writer.putI64(item.getPrice().getCents());
+    writer.putI32(item.getQuantity());
+    writer.putString(item.getName());
+    writer.putString(item.getAisle());
+}
+
+bool getItem(ByteReader& reader, GroceryItem& item) {
+    uint64_t upc;
+    int64_t cents;
+    int32_t quantity;
+    std::string_view name, aisle;
+    if (!reader.getU64(upc) || !reader.getI64(cents) || !reader.getI32(quantity) ||
+        !reader.getString(name) || !reader.getString(aisle)) {
+        return false;
+    }
+    item = GroceryItem(name, UpcKey::fromRaw(upc), Money::fromCents(cents), quantity, aisle);
+    return true;
+}
+
+// Apply one decoded log record; false if it does not decode
+bool applyRecord(AVLTree& inventory, uint8_t type, ByteReader& reader) {
+    GroceryItem item;
+    uint64_t upc;
+    int32_t delta;
+    switch (type) {
+    case kInsert:
+        if (!getItem(reader, item)) return false;
+        inventory.insert(item);
+        return true;
+    case kUpdate:
+        if (!getItem(reader, item)) return false;
+        inventory.update(item.getUpc(), item);
+        return true;
+    case kRemove:
+        if (!reader.getU64(upc)) return false;
+        inventory.remove(UpcKey::fromRaw(upc));
+        return true;
+    case kStockChange: {
+        if (!reader.getU64(upc) || !reader.getI32(delta)) return false;
+        GroceryItem* found = inventory.search(UpcKey::fromRaw(upc));
+        if (found != nullptr) inventory.adjustStock(*found, delta);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+InventoryLog::InventoryLog(const std::string& logFile, const std::string& checkpointFile,
+                           const InventoryLogOptions& options)
+    : logFile(logFile), checkpointFile(checkpointFile), options(options),
+      inventory(nullptr), nextSequence(1), sinceCheckpoint(0) {
+}
+
+InventoryLog::~InventoryLog() {
+    close();
+}
+
+// Load the checkpoint into the inventory: an image is checked against its
+// CRC and decoded straight into a bottom-up tree build
+bool InventoryLog::loadCheckpoint(InventoryRecoveryResult& result) {
+    InventoryImage image;
+    ImageStatus status = image.open(checkpointFile);
+    if (status == ImageStatus::Missing) {
+        return true; // no checkpoint yet
+    }
+    if (status == ImageStatus::WrongFormat) {
+        return loadJournalCheckpoint(result);
+    }
+    if (status != ImageStatus::Ok || !image.verify() || !image.buildTree(*inventory)) {
+        std::cerr << "Error: " << checkpointFile << " is damaged; the inventory will not be restored.\n";
+        return false;
+    }
+    result.restored = true;
+    result.checkpointItems = image.size();
+    result.lastSequence = image.lastSequence();
+    nextSequence = image.lastSequence() + 1;
+    return true;
+}
+
+// Checkpoints written before they were images: a journal of Begin, Items
+// and End records. It counts only if all of them are there.
+bool InventoryLog::loadJournalCheckpoint(InventoryRecoveryResult& result) {
+    std::vector<GroceryItem> items;
+    uint64_t sequence = 0;
+    uint64_t expected = 0;
+    bool begun = false;
+    bool ended = false;
+    bool malformed = false;
+    JournalReader::ScanResult scan = JournalReader::scan(checkpointFile,
+        [&](const unsigned char* payload, size_t length) {
+            ByteReader reader(payload, length);
+            uint8_t type;
+            uint32_t count;
+            uint64_t total;
+            if (!reader.getU8(type)) {
+                malformed = true;
+            } else if (type == kCheckpointBegin && !begun) {
+                begun = reader.getU64(sequence) && reader.getU64(expected);
+                malformed = !begun;
+                items.reserve(static_cast<size_t>(expected));
+            } else if (type == kCheckpointItems && begun && reader.getU32(count)) {
+                for (uint32_t i = 0; i < count && !malformed; ++i) {
+                    items.emplace_back();
+                    malformed = !getItem(reader, items.back());
+                }
+            } else if (type == kCheckpointEnd && begun && reader.getU64(total)) {
+                ended = total == expected && items.size() == expected;
+                malformed = !ended;
+            } else {
+                malformed = true;
+            }
+            return !malformed && !ended;
+        });
+    if (!scan.opened) {
+        return true; // no checkpoint yet
+    }
+    if (!scan.headerValid || !ended) {
+        std::cerr << "Error: " << checkpointFile << " is damaged; the inventory will not be restored.\n";
+        return false;
+    }
+    result.restored = true;
+    result.checkpointItems = items.size();
+    result.lastSequence = sequence;
+    nextSequence = sequence + 1;
+    inventory->assignSorted(std::move(items)); // written in UPC order
+    return true;
+}
+
+// Replay the log records the checkpoint does not cover yet
+bool InventoryLog::replayLog(InventoryRecoveryResult& result, uint64_t& validLength) {
+    JournalReader::ScanResult scan = JournalReader::scan(logFile,
+        [&](const unsigned char* payload, size_t length) {
+            ByteReader reader(payload, length);
+            uint8_t type;
+            uint64_t sequence;
+            if (!reader.getU8(type) || !reader.getU64(sequence)) {
+                result.malformed++;
+                return true;
+            }
+            if (sequence < nextSequence) {
+                return true; // already in the checkpoint
+            }
+            if (!applyRecord(*inventory, type, reader)) {
+                result.malformed++;
+            }
+            result.replayed++;
+            result.restored = true;
+            result.lastSequence = sequence;
+            nextSequence = sequence + 1;
+            return true;
+        });
+
+    validLength = scan.validLength;
+    result.truncatedTail = scan.truncatedTail;
+    if (scan.opened && !scan.headerValid) {
+        std::cerr << "Error: " << logFile << " is not an inventory log; "
+                  << "inventory changes will not be saved.\n";
+        return false;
+    }
+    return true;
+}
+
+InventoryRecoveryResult InventoryLog::open(AVLTree& target) {
+    close();
+    InventoryRecoveryResult result{false, false, 0, 0, 0, false, 0};
+    target.clear();
+    inventory = &target;
+    nextSequence = 1;
+    sinceCheckpoint = 0;
+
+    uint64_t validLength = 0;
+    if (!loadCheckpoint(result) || !replayLog(result, validLength)) {
+        inventory = nullptr;
+        return result;
+    }
+    if (result.malformed > 0) {
+        std::cerr << "Warning: Skipped " << result.malformed << " malformed inventory log record(s).\n";
+    }
+    if (result.truncatedTail) {
+        std::cerr << "Warning: Discarding incomplete record at the end of " << logFile << ".\n";
+    }
+
+    if (!journal.open(logFile, validLength)) {
+        std::cerr << "Error: Could not open inventory log file for writing.\n";
+        inventory = nullptr;
+        return result;
+    }
+    commitLog.start(&journal, options.durability);
+    target.setListener(this);
+    result.opened = true;
+    return result;
+}
+
+bool InventoryLog::checkpoint() {
+    if (inventory == nullptr || !commitLog.flush()) {
+        return false;
+    }
+
+    std::string pending = checkpointFile + ".tmp";
+    if (!writeInventoryImage(pending, *inventory, nextSequence - 1)) {
+        std::cerr << "Error: Could not write inventory checkpoint.\n";
+        return false;
+    }
+    std::error_code ec;
+    std::filesystem::rename(pending, checkpointFile, ec);
+    if (ec) {
+        std::cerr << "Error: Could not replace " << checkpointFile << ".\n";
+        return false;
+    }
+
+    // Everything in the log is now in the checkpoint; start it over. The
+    // empty log is also swapped in by rename, so the log on disk always
+    // has a valid header.
+    commitLog.stop();
+    journal.close();
+    std::string fresh = logFile + ".tmp";
+    JournalWriter empty;
+    bool ok = empty.open(fresh, 0) && empty.sync();
+    empty.close();
+    uint64_t headerLength = ok ? std::filesystem::file_size(fresh, ec) : 0;
+    if (ok && !ec) {
+        std::filesystem::rename(fresh, logFile, ec);
+    }
+    if (!ok || ec || !journal.open(logFile, headerLength)) {
+        std::cerr << "Error: Could not start a new inventory log after the checkpoint.\n";
+        std::filesystem::remove(fresh, ec);
+        resumeLog();
+        return false;
+    }
+    commitLog.start(&journal, options.durability);
+    sinceCheckpoint = 0;
+    return true;
+}
+
+// After a checkpoint could not swap in an empty log: go on appending to
+// whatever log is on disk, so later changes are not dropped. Its records
+// up to the checkpoint are skipped on replay. If the log cannot be
+// reopened either, stop listening; isOpen() then reports it.
+bool InventoryLog::resumeLog() {
+    std::error_code ec;
+    uint64_t length = std::filesystem::file_size(logFile, ec);
+    if (!ec && journal.open(logFile, length)) {
+        commitLog.start(&journal, options.durability);
+        sinceCheckpoint = 0; // try again after another checkpointEvery records
+        return true;
+    }
+    std::cerr << "Error: Could not reopen " << logFile << "; inventory changes will no longer be saved.\n";
+    close();
+    return false;
+}
+
+bool InventoryLog::checkpointIfDue() {
+    if (options.checkpointEvery == 0 || sinceCheckpoint < options.checkpointEvery) {
+        return true;
+    }
+    return checkpoint();
+}
+
+bool InventoryLog::flush() {
+    return commitLog.flush();
+}
+
+void InventoryLog::close() {
+    if (inventory != nullptr) {
+        inventory->setListener(nullptr);
+        inventory = nullptr;
+    }
+    commitLog.stop();
+    journal.close();
+}
+
+// Queue the record in recordBuffer
+void InventoryLog::submit() {
+    commitLog.submit(recordBuffer);
+    sinceCheckpoint++;
+}
+
+void InventoryLog::onInsert(const GroceryItem& item) {
+    recordBuffer.clear();
+    ByteWriter writer(recordBuffer);
+    writer.putU8(kInsert);
+    writer.putU64(nextSequence++);
+    putItem(writer, item);
+    submit();
+}
+
+void InventoryLog::onUpdate(UpcKey upc, const GroceryItem& item) {
+    GroceryItem keyed = item;
+    keyed.setUpc(upc);
+    recordBuffer.clear();
+    ByteWriter writer(recordBuffer);
+    writer.putU8(kUpdate);
+    writer.putU64(nextSequence++);
+    putItem(writer, keyed);
+    submit();
+}
+
+void InventoryLog::onRemove(UpcKey upc) {
+    recordBuffer.clear();
+    ByteWriter writer(recordBuffer);
+    writer.putU8(kRemove);
+    writer.putU64(nextSequence++);
+    writer.putU64(upc.raw());
+    submit();
+}
+
+void InventoryLog::onStockChange(UpcKey upc, int delta) {
+    recordBuffer.clear();
+    ByteWriter writer(recordBuffer);
+    writer.putU8(kStockChange);
+    writer.putU64(nextSequence++);
+    writer.putU64(upc.raw());
+    writer.putI32(delta);
+    submit();
+}
+
+// FastStartInventory
+
+FastStartInventory::FastStartInventory(InventoryLog& log, AVLTree& target)
+    : log(log), tree(target), ready(false), result{false, false, 0, 0, 0, false, 0} {
+}
+
+FastStartInventory::~FastStartInventory() {
+    wait();
+}
+
+bool FastStartInventory::start() {
+    wait();
+    ready.store(false, std::memory_order_relaxed);
+    std::error_code ec;
+    uint64_t logSize = std::filesystem::file_size(log.getLogFile(), ec);
+    bool logEmpty = ec || logSize <= JournalWriter::kHeaderSize;
+    if (!logEmpty || image.open(log.getCheckpointFile()) != ImageStatus::Ok) {
+        image.close();
+    }
+    recovery = std::thread([this] {
+        result = log.open(tree);
+        ready.store(true, std::memory_order_release);
+    });
+    return image.isOpen();
+}
+
+bool FastStartInventory::lookup(UpcKey upcCode, GroceryItem& out) const {
+    if (isReady()) {
+        const GroceryItem* item = static_cast<const AVLTree&>(tree).search(upcCode);
+        if (item == nullptr) return false;
+        out = *item;
+        return true;
+    }
+    return image.isOpen() && image.find(upcCode, out);
+}
+
+const InventoryRecoveryResult& FastStartInventory::wait() {
+    if (recovery.joinable()) {
+        recovery.join();
+        image.close(); // the tree answers from now on
+    }
+    return result;
+}
@@ -0,0 +1,153 @@
+// InventoryLog.h - Write-ahead log and checkpoints that persist the inventory
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef INVENTORY_LOG_H
+#define INVENTORY_LOG_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AVLTree.h"
+#include "GroupCommitLog.h"
+#include "InventoryImage.h"
+#include "TransactionJournal.h"
+
+// The inventory is kept on disk as a checkpoint plus a write-ahead log of
+// every change made since.
+//
+//   log        : CRC-framed journal (TransactionJournal.h), one record per
+//                change. u8 type, u64 sequence number, then
+//                Insert/Update: u64 packed UpcKey, i64 price in cents,
+//                               i32 quantity, name, aisle
+//                Remove       : u64 packed UpcKey
+//                StockChange  : u64 packed UpcKey, i32 delta
+//   checkpoint : an InventoryImage (InventoryImage.h) whose header records
+//                the last sequence number it covers. Checkpoints written as
+//                a journal of Begin/Items/End records by older versions are
+//                still read.
+//
+// Recovery loads the checkpoint and replays only the log records with a
+// higher sequence number. A checkpoint is written beside the old one and
+// renamed over it once synced, and only then is the log cut back to empty,
+// so a crash at any point leaves a checkpoint and a log that together hold
+// every change that reached the disk.
+struct InventoryRecoveryResult {
+    bool opened;             // false if the files could not be read or written
+    bool restored;           // an earlier inventory was found on disk
+    size_t checkpointItems;  // items loaded from the checkpoint
+    size_t replayed;         // log records applied on top of it
+    size_t malformed;        // log records that did not decode
+    bool truncatedTail;      // a torn record at the end of the log was dropped
+    uint64_t lastSequence;   // sequence number of the last change recovered
+};
+
+struct InventoryLogOptions {
+    GroupCommitOptions durability;
+    size_t checkpointEvery; // log records between automatic checkpoints (0 = never)
+
+    InventoryLogOptions() : checkpointEvery(10000) {}
+};
+
+// Rebuilds an AVLTree from disk and then listens to it, queuing one log
+// record per change on a GroupCommitLog. Records are written and synced in
+// batches by the log's writer thread; the inventory itself never waits on
+// the disk.
+class InventoryLog : public InventoryListener {
+private:
+    std::string logFile;
+    std::string checkpointFile;
+    InventoryLogOptions options;
+    AVLTree* inventory;
+    JournalWriter journal;
+    GroupCommitLog commitLog;
+    std::vector<unsigned char> recordBuffer;
+    uint64_t nextSequence;
+    size_t sinceCheckpoint; // records logged since the last checkpoint
+
+    bool loadCheckpoint(InventoryRecoveryResult& result);
+    bool replayLog(InventoryRecoveryResult& result, uint64_t& validLength);
+    bool loadJournalCheckpoint(InventoryRecoveryResult& result);
+    bool resumeLog();
+    void submit();
+
+public:
+    InventoryLog(const std::string& logFile = "inventory.log",
+                 const std::string& checkpointFile = "inventory.ckpt",
+                 const InventoryLogOptions& options = InventoryLogOptions());
+
+    // Stops listening, then writes out and syncs anything still queued
+    ~InventoryLog();
+
+    InventoryLog(const InventoryLog&) = delete;
+    InventoryLog& operator=(const InventoryLog&) = delete;
+
+    // Replace target's contents with the inventory on disk (empty if there
+    // is none yet), then log every later change made to it
+    InventoryRecoveryResult open(AVLTree& target);
+
+    // Write the whole inventory as a new checkpoint and empty the log. On
+    // failure the old log keeps being appended to; if even that is
+    // impossible the log closes itself (isOpen() turns false).
+    bool checkpoint();
+
+    // checkpoint() once checkpointEvery records have been logged since the
+    // last one; call between operations, not from inside one
+    bool checkpointIfDue();
+
+    // Barrier: returns once every change logged so far is on disk
+    bool flush();
+
+    // Stop listening and shut the writer down
+    void close();
+
+    bool isOpen() const { return inventory != nullptr; }
+    uint64_t lastSequence() const { return nextSequence - 1; }
+    const std::string& getLogFile() const { return logFile; }
+    const std::string& getCheckpointFile() const { return checkpointFile; }
+
+    void onInsert(const GroceryItem& item) override;
+    void onUpdate(UpcKey upc, const GroceryItem& item) override;
+    void onRemove(UpcKey upc) override;
+    void onStockChange(UpcKey upc, int delta) override;
+};
+
+// Runs InventoryLog::open on a background thread so the program can start
+// at once. Until recovery is done, lookups are answered from the mapped
+// checkpoint image (header checked, O(1) in the number of items) -- but
+// only when the log holds no changes past it, as after a clean shutdown,
+// so the image says exactly what the tree will. The tree and the log must
+// not be touched until wait() returns.
+class FastStartInventory {
+private:
+    InventoryLog& log;
+    AVLTree& tree;
+    InventoryImage image; // open only while it matches the inventory exactly
+    std::thread recovery;
+    std::atomic<bool> ready;
+    InventoryRecoveryResult result;
+
+public:
+    FastStartInventory(InventoryLog& log, AVLTree& target);
+    ~FastStartInventory();
+
+    FastStartInventory(const FastStartInventory&) = delete;
+    FastStartInventory& operator=(const FastStartInventory&) = delete;
+
+    // Map the checkpoint and start recovery; returns without waiting.
+    // True if lookups can be answered before recovery is done.
+    bool start();
+
+    // Served from the image while recovering, then from the tree; false
+    // while recovering without a usable image
+    bool lookup(UpcKey upcCode, GroceryItem& out) const;
+
+    bool isReady() const { return ready.load(std::memory_order_acquire); }
+
+    // Wait for recovery and return what InventoryLog::open returned
+    const InventoryRecoveryResult& wait();
+};
+
+#endif // INVENTORY_LOG_H
@@ -0,0 +1,67 @@
+// LoaderUtil.h - Helpers shared by the file loaders
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef LOADER_UTIL_H
+#define LOADER_UTIL_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// Files are parsed straight out of a memory mapping: fields are
+// string_views into the mapping and numbers go through std::from_chars,
+// so the only allocations are the ones the finished objects need.
+
+// One thread per ~1 MiB of input, capped at the number of cores
+inline size_t loaderThreadsFor(size_t bytes) {
+    size_t cores = std::thread::hardware_concurrency();
+    if (cores == 0) cores = 1;
+    return std::min(cores, bytes / (size_t(1) << 20) + 1);
+}
+
+// Run work(part) for every part in [0, parts); the calling thread takes part 0
+template <typename Work>
+void runParallel(size_t parts, Work work) {
+    std::vector<std::thread> threads;
+    threads.reserve(parts > 0 ? parts - 1 : 0);
+    for (size_t part = 1; part < parts; ++part) {
+        threads.emplace_back(work, part);
+    }
+    if (parts > 0) work(0);
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+}
+
+// Offsets cutting text into parts chunks that each end at a line break;
+// chunk i is [bounds[i], bounds[i + 1])
+inline std::vector<size_t> splitAtLines(std::string_view text, size_t parts) {
+    std::vector<size_t> bounds(parts + 1, text.size());
+    bounds[0] = 0;
+    for (size_t part = 1; part < parts; ++part) {
+        size_t cut = std::max(bounds[part - 1], text.size() * part / parts);
+        size_t newline = text.find('\n', cut);
+        bounds[part] = newline == std::string_view::npos ? text.size() : newline + 1;
+    }
+    return bounds;
+}
+
+template <typename T>
+bool parseNumber(std::string_view field, T& value) {
+    const char* end = field.data() + field.size();
+    std::from_chars_result result = std::from_chars(field.data(), end, value);
+    return result.ec == std::errc() && result.ptr == end;
+}
+
+// Cut the text up to the next separator off the front of rest
+inline std::string_view nextField(std::string_view& rest, char separator) {
+    size_t end = rest.find(separator);
+    std::string_view field = rest.substr(0, end);
+    rest = end == std::string_view::npos ? std::string_view() : rest.substr(end + 1);
+    return field;
+}
+
+#endif // LOADER_UTIL_H
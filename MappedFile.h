@@ -0,0 +1,45 @@
+// MappedFile.h - Read-only memory-mapped view of a file
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// Maps a whole file read-only so loaders can parse it in place. The view
+// stays valid until close() or destruction.
+class MappedFile {
+private:
+    const unsigned char* bytes;
+    size_t length;
+    bool opened;
+#if defined(_WIN32)
+    void* fileHandle;
+    void* mappingHandle;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Returns false if the file does not exist or cannot be mapped. An
+    // empty file opens successfully with size() == 0.
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return opened; }
+    const unsigned char* data() const { return bytes; }
+    size_t size() const { return length; }
+    std::string_view view() const {
+        return std::string_view(reinterpret_cast<const char*>(bytes), length);
+    }
+};
+
+#endif // MAPPED_FILE_H
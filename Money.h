@@ -0,0 +1,155 @@
+// Money.h - Fixed-point currency amounts in integer cents
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef MONEY_H
+#define MONEY_H
+
+#include <cmath>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// How a fractional cent is resolved
+enum class Rounding {
+    HalfUp,   // 0.5 cent goes away from zero (sales tax)
+    HalfEven, // 0.5 cent goes to the even cent (banker's rounding)
+    Down      // fraction dropped, toward zero
+};
+
+// A dollar amount stored as a signed 64-bit count of cents. Adding,
+// subtracting and multiplying by a quantity are exact, so totals kept
+// across long carts and years of history never drift. The only places a
+// fraction of a cent can appear (rates and division) take an explicit
+// Rounding.
+class Money {
+private:
+    int64_t cents;
+
+    explicit constexpr Money(int64_t amount) : cents(amount) {}
+
+    // numerator / denominator rounded per mode; denominator > 0
+    static int64_t divide(int64_t numerator, int64_t denominator, Rounding mode) {
+        int64_t quotient = numerator / denominator;
+        int64_t remainder = numerator % denominator;
+        if (remainder == 0 || mode == Rounding::Down) return quotient;
+
+        int64_t twice = 2 * (remainder < 0 ? -remainder : remainder);
+        int64_t away = numerator < 0 ? -1 : 1;
+        if (twice > denominator) return quotient + away;
+        if (twice < denominator) return quotient;
+        if (mode == Rounding::HalfUp) return quotient + away;
+        return quotient % 2 == 0 ? quotient : quotient + away; // HalfEven
+    }
+
+public:
+    constexpr Money() : cents(0) {}
+
+    static constexpr Money fromCents(int64_t amount) { return Money(amount); }
+
+    // Nearest cent to a floating-point dollar amount (half away from zero);
+    // used when reading data written before amounts were stored in cents
+    static Money fromDouble(double dollars) {
+        return Money(static_cast<int64_t>(std::llround(dollars * 100.0)));
+    }
+
+    // Parse "12", "12.3", "12.34", "-0.99" or "$4.50". Digits past the
+    // cents are rounded per mode. Returns false (leaving out untouched)
+    // on anything else.
+    static bool parse(std::string_view text, Money& out, Rounding mode = Rounding::HalfUp) {
+        bool negative = false;
+        if (!text.empty() && (text[0] == '-' || text[0] == '+')) {
+            negative = text[0] == '-';
+            text.remove_prefix(1);
+        }
+        if (!text.empty() && text[0] == '$') text.remove_prefix(1);
+
+        int64_t whole = 0;
+        size_t i = 0;
+        for (; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+            if (whole >= 1000000000000000) return false; // keeps the math below in range
+            whole = whole * 10 + (text[i] - '0');
+        }
+        size_t wholeDigits = i;
+
+        // Keep cents plus one extra digit; later digits only matter for
+        // breaking a tie at exactly half a cent
+        int64_t fraction = 0;
+        size_t fractionDigits = 0;
+        bool sticky = false;
+        if (i < text.size() && text[i] == '.') {
+            for (++i; i < text.size() && text[i] >= '0' && text[i] <= '9'; ++i) {
+                if (fractionDigits < 3) {
+                    fraction = fraction * 10 + (text[i] - '0');
+                    fractionDigits++;
+                } else if (text[i] != '0') {
+                    sticky = true;
+                }
+            }
+            if (fractionDigits == 0 && wholeDigits == 0) return false;
+        }
+        if (i != text.size() || (wholeDigits == 0 && fractionDigits == 0)) return false;
+
+        while (fractionDigits < 3) {
+            fraction *= 10;
+            fractionDigits++;
+        }
+        // Twice the tenths of a cent, plus a sticky bit so 0.0050001 is
+        // treated as above the tie
+        int64_t mills = (whole * 1000 + fraction) * 2 + (sticky ? 1 : 0);
+        int64_t amount = divide(negative ? -mills : mills, 20, mode);
+        out = Money(amount);
+        return true;
+    }
+
+    int64_t getCents() const { return cents; }
+    double toDouble() const { return static_cast<double>(cents) / 100.0; }
+    bool isZero() const { return cents == 0; }
+
+    // Rate in basis points (1/100 of a percent, so 8.25% is 825)
+    Money percent(int64_t basisPoints, Rounding mode = Rounding::HalfUp) const {
+        // Split so cents * basisPoints cannot overflow
+        int64_t whole = cents / 10000;
+        int64_t rest = cents % 10000;
+        return Money(whole * basisPoints + divide(rest * basisPoints, 10000, mode));
+    }
+
+    // Share of this amount per item (e.g. an average); count > 0
+    Money dividedBy(int64_t count, Rounding mode = Rounding::HalfUp) const {
+        return Money(divide(cents, count, mode));
+    }
+
+    Money operator+(Money other) const { return Money(cents + other.cents); }
+    Money operator-(Money other) const { return Money(cents - other.cents); }
+    Money operator-() const { return Money(-cents); }
+    Money operator*(int64_t quantity) const { return Money(cents * quantity); }
+    Money& operator+=(Money other) { cents += other.cents; return *this; }
+    Money& operator-=(Money other) { cents -= other.cents; return *this; }
+
+    bool operator==(Money other) const { return cents == other.cents; }
+    bool operator!=(Money other) const { return cents != other.cents; }
+    bool operator<(Money other) const { return cents < other.cents; }
+    bool operator>(Money other) const { return cents > other.cents; }
+    bool operator<=(Money other) const { return cents <= other.cents; }
+    bool operator>=(Money other) const { return cents >= other.cents; }
+
+    // "12.34" / "-0.05" (no currency sign)
+    std::string toString() const {
+        uint64_t magnitude = cents < 0 ? 0 - static_cast<uint64_t>(cents) : static_cast<uint64_t>(cents);
+        std::string text = std::to_string(magnitude / 100);
+        text += '.';
+        text += static_cast<char>('0' + magnitude % 100 / 10);
+        text += static_cast<char>('0' + magnitude % 10);
+        return cents < 0 ? "-" + text : text;
+    }
+};
+
+inline Money operator*(int64_t quantity, Money amount) {
+    return amount * quantity;
+}
+
+inline std::ostream& operator<<(std::ostream& os, Money amount) {
+    return os << amount.toString();
+}
+
+#endif // MONEY_H
@@ -0,0 +1,91 @@
+#ifndef NODE_POOL_H
+#define NODE_POOL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Slab allocator that hands out 32-bit slot indices instead of pointers.
+// Slots live in equal blocks of about 256 KB, a power-of-two number of
+// slots each, so a pool of millions of nodes is a few hundred allocations,
+// turning an index into a slot is a shift, a mask and one load from a
+// small block table, and a slot never moves once it has been handed out
+// (references stay valid across growth).
+template <typename T>
+class NodePool {
+public:
+    static constexpr uint32_t npos = 0xFFFFFFFFu;
+
+private:
+    static constexpr size_t kTargetBlockBytes = 256 * 1024;
+
+    // floor(log2(n)), and 0 for n <= 1
+    static constexpr unsigned floorLog2(size_t n) {
+        return n <= 1 ? 0 : 1 + floorLog2(n / 2);
+    }
+
+    static constexpr unsigned kBlockBits = floorLog2(kTargetBlockBytes / sizeof(T));
+    static constexpr uint32_t kBlockSlots = 1u << kBlockBits;
+
+    std::vector<std::unique_ptr<T[]>> blocks;
+    std::vector<uint32_t> freeSlots;
+    uint32_t highWater; // slots [0, highWater) have been handed out at least once
+    uint32_t capacitySlots;
+
+    void grow() {
+        blocks.emplace_back(new T[kBlockSlots]);
+        capacitySlots += kBlockSlots;
+    }
+
+public:
+    NodePool() : highWater(0), capacitySlots(0) {}
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Returns the index of a free slot. The slot keeps whatever value it last
+    // held; callers assign a fresh value before linking it in.
+    uint32_t allocate() {
+        if (!freeSlots.empty()) {
+            uint32_t index = freeSlots.back();
+            freeSlots.pop_back();
+            return index;
+        }
+        if (highWater == capacitySlots) {
+            grow();
+        }
+        return highWater++;
+    }
+
+    void release(uint32_t index) {
+        freeSlots.push_back(index);
+    }
+
+    T& operator[](uint32_t index) {
+        return blocks[index >> kBlockBits][index & (kBlockSlots - 1)];
+    }
+
+    const T& operator[](uint32_t index) const {
+        return blocks[index >> kBlockBits][index & (kBlockSlots - 1)];
+    }
+
+    // Reserve room for at least n slots up front (bulk loads).
+    void reserve(size_t n) {
+        while (capacitySlots < n) {
+            grow();
+        }
+    }
+
+    // Forget every slot at once. Blocks are kept for reuse.
+    void reset() {
+        freeSlots.clear();
+        highWater = 0;
+    }
+
+    size_t size() const { return highWater - freeSlots.size(); }
+    size_t capacity() const { return capacitySlots; }
+    size_t blockCount() const { return blocks.size(); }
+};
+
+#endif
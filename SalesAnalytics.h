@@ -0,0 +1,185 @@
+// SalesAnalytics.h - Incremental best-seller tracking for the sales report
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef SALES_ANALYTICS_H
+#define SALES_ANALYTICS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "GroceryItem.h"
+
+struct ProductSales {
+    UpcKey upc;
+    InternedString name;
+    int64_t units;
+};
+
+// Best sellers first; ties broken by UPC so reports are stable
+inline bool sellsBetter(const ProductSales& a, const ProductSales& b) {
+    return a.units != b.units ? a.units > b.units : a.upc < b.upc;
+}
+
+// Exact units sold per product, updated one line item at a time. A top-K
+// query only orders the K winners (O(n log K)) instead of sorting every
+// product ever sold.
+class ProductSalesTracker {
+private:
+    std::unordered_map<UpcKey, uint32_t> slotOf;
+    std::vector<ProductSales> products;
+
+public:
+    void record(const GroceryItem& item, int quantity) {
+        auto found = slotOf.find(item.getUpc());
+        if (found == slotOf.end()) {
+            slotOf.emplace(item.getUpc(), static_cast<uint32_t>(products.size()));
+            products.push_back(ProductSales{item.getUpc(), item.getNameHandle(), quantity});
+        } else {
+            products[found->second].units += quantity;
+        }
+    }
+
+    std::vector<ProductSales> topK(size_t k) const {
+        std::vector<const ProductSales*> order;
+        order.reserve(products.size());
+        for (const ProductSales& product : products) {
+            order.push_back(&product);
+        }
+        k = std::min(k, order.size());
+        std::partial_sort(order.begin(), order.begin() + k, order.end(),
+            [](const ProductSales* a, const ProductSales* b) { return sellsBetter(*a, *b); });
+
+        std::vector<ProductSales> result;
+        result.reserve(k);
+        for (size_t i = 0; i < k; ++i) {
+            result.push_back(*order[i]);
+        }
+        return result;
+    }
+
+    size_t productCount() const { return products.size(); }
+
+    void clear() {
+        slotOf.clear();
+        products.clear();
+    }
+};
+
+// Approximate heavy hitters in bounded memory: a Count-Min sketch estimates
+// each product's units sold (never under-counting), and an indexed min-heap
+// keeps the K products with the largest estimates seen so far. Memory is
+// fixed at construction no matter how many distinct products are sold.
+class HeavyHittersSketch {
+private:
+    static constexpr size_t kDepth = 4;
+
+    size_t width; // power of two
+    size_t capacity;
+    std::vector<uint32_t> counters; // kDepth rows of width counters
+    std::vector<ProductSales> heap; // min-heap on units (the sketch estimate)
+    std::unordered_map<UpcKey, size_t> heapPos;
+
+    size_t column(size_t row, UpcKey upc) const {
+        static const uint64_t multipliers[kDepth] = {
+            0x9E3779B97F4A7C15ull, 0xC2B2AE3D27D4EB4Full,
+            0x165667B19E3779F9ull, 0xD6E8FEB86659FD93ull
+        };
+        uint64_t h = (upc.raw() + row) * multipliers[row];
+        return static_cast<size_t>(h >> 32) & (width - 1);
+    }
+
+    bool less(size_t a, size_t b) const {
+        return sellsBetter(heap[b], heap[a]); // "a sells worse than b"
+    }
+
+    void swapEntries(size_t a, size_t b) {
+        std::swap(heap[a], heap[b]);
+        heapPos[heap[a].upc] = a;
+        heapPos[heap[b].upc] = b;
+    }
+
+    void siftUp(size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!less(i, parent)) break;
+            swapEntries(i, parent);
+            i = parent;
+        }
+    }
+
+    void siftDown(size_t i) {
+        while (true) {
+            size_t smallest = i;
+            size_t left = 2 * i + 1;
+            size_t right = left + 1;
+            if (left < heap.size() && less(left, smallest)) smallest = left;
+            if (right < heap.size() && less(right, smallest)) smallest = right;
+            if (smallest == i) break;
+            swapEntries(i, smallest);
+            i = smallest;
+        }
+    }
+
+public:
+    // memoryBudget bounds the sketch counters; k is how many candidates
+    // are tracked (ask topK for at most k)
+    HeavyHittersSketch(size_t memoryBudget, size_t k) : width(1), capacity(k) {
+        while (width * 2 * kDepth * sizeof(uint32_t) <= memoryBudget) width *= 2;
+        counters.assign(kDepth * width, 0);
+        heap.reserve(capacity);
+    }
+
+    void record(const GroceryItem& item, int quantity) {
+        if (quantity <= 0) return;
+        UpcKey upc = item.getUpc();
+        uint32_t estimate = UINT32_MAX;
+        for (size_t row = 0; row < kDepth; ++row) {
+            uint32_t& counter = counters[row * width + column(row, upc)];
+            counter += static_cast<uint32_t>(quantity);
+            estimate = std::min(estimate, counter);
+        }
+
+        auto found = heapPos.find(upc);
+        if (found != heapPos.end()) {
+            heap[found->second].units = estimate;
+            siftDown(found->second);
+            return;
+        }
+        if (capacity == 0) return;
+        ProductSales candidate{upc, InternedString(), estimate};
+        if (heap.size() < capacity) {
+            candidate.name = item.getNameHandle();
+            heap.push_back(candidate);
+            heapPos[upc] = heap.size() - 1;
+            siftUp(heap.size() - 1);
+        } else if (sellsBetter(candidate, heap[0])) {
+            heapPos.erase(heap[0].upc);
+            candidate.name = item.getNameHandle();
+            heap[0] = candidate;
+            heapPos[upc] = 0;
+            siftDown(0);
+        }
+    }
+
+    // Estimated best sellers, best first
+    std::vector<ProductSales> topK(size_t k) const {
+        std::vector<ProductSales> result(heap);
+        std::sort(result.begin(), result.end(), sellsBetter);
+        if (result.size() > k) result.resize(k);
+        return result;
+    }
+
+    size_t memoryUsage() const {
+        return counters.capacity() * sizeof(uint32_t) + heap.capacity() * sizeof(ProductSales);
+    }
+
+    void clear() {
+        std::fill(counters.begin(), counters.end(), 0);
+        heap.clear();
+        heapPos.clear();
+    }
+};
+
+#endif // SALES_ANALYTICS_H
@@ -1,96 +1,367 @@
 #ifndef SHOPPING_CART_H
 #define SHOPPING_CART_H
 
+#include <climits>
+#include <cstdint>
 #include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <utility>
 #include "GroceryItem.h"
 #include "AVLTree.h"
+#include "ConcurrentInventory.h"
+#include "VersionedInventory.h"
 #include <iostream>
 #include <iomanip>
 
+// One line of a cart. Name and aisle stay in the inventory; the line keeps
+// only what pricing and stock need. sku is kNoSku for AVLTree inventories.
+struct CartLine {
+    UpcKey upc;
+    SkuHandle sku;
+    Money unitPrice; // price when the first unit was added
+    int quantity;
+};
+
+// Outcome of ShoppingCart::addItems
+struct BatchScanResult {
+    std::vector<StockStatus> status; // one per scan, in the order given
+    size_t accepted;                 // scans that went into the cart
+    int64_t unitsAdded;
+};
+
 class ShoppingCart {
 private:
-    std::vector<GroceryItem> items;
-    double totalCost;
+    std::vector<CartLine> lines;
+    std::unordered_map<UpcKey, uint32_t> lineIndex; // UPC -> position in lines
+    Money totalCost;
     int totalItems;
 
+    // Scratch for addItems, kept so a batch allocates only its result
+    std::vector<uint32_t> batchOrder;
+    std::vector<UpcKey> batchKeys;
+    std::vector<int64_t> batchQuantities;
+    std::vector<size_t> batchRunStart;
+    std::vector<GroceryItem*> batchFound;
+    
+    // Position of the line for upcCode, or -1
+    long findLine(UpcKey upcCode) const {
+        auto found = lineIndex.find(upcCode);
+        return found == lineIndex.end() ? -1 : static_cast<long>(found->second);
+    }
+    
+    // Drop a line by moving the last one into its place
+    void eraseLine(size_t position) {
+        lineIndex.erase(lines[position].upc);
+        if (position != lines.size() - 1) {
+            lines[position] = lines.back();
+            lineIndex[lines[position].upc] = static_cast<uint32_t>(position);
+        }
+        lines.pop_back();
+    }
+    
+    // Merge quantity units of item into the cart (stock already taken)
+    void addToCart(const GroceryItem& item, int quantity) {
+        auto inserted = lineIndex.emplace(item.getUpc(), static_cast<uint32_t>(lines.size()));
+        if (inserted.second) {
+            lines.push_back(CartLine{item.getUpc(), item.getSku(), item.getPrice(), quantity});
+        } else {
+            lines[inserted.first->second].quantity += quantity;
+        }
+        totalCost += lines[inserted.first->second].unitPrice * quantity;
+        totalItems += quantity;
+    }
+    
+    // Take quantity units off a line; false if the line has fewer
+    bool takeFromLine(size_t position, int quantity) {
+        CartLine& line = lines[position];
+        if (quantity <= 0 || line.quantity < quantity) {
+            return false;
+        }
+        line.quantity -= quantity;
+        totalCost -= line.unitPrice * quantity;
+        totalItems -= quantity;
+        if (line.quantity == 0) {
+            eraseLine(position);
+        }
+        return true;
+    }
+    
+    static void printLine(const CartLine& line, const GroceryItem* item) {
+        std::cout << "UPC: " << line.upc 
+                  << ", Name: " << (item != nullptr ? item->getName() : "(no longer stocked)") 
+                  << ", Price: $" << line.unitPrice 
+                  << ", Quantity: " << line.quantity 
+                  << ", Aisle: " << (item != nullptr ? item->getAisle() : "") 
+                  << std::endl;
+    }
+    
+    void printTotals() const {
+        std::cout << "Total Cost: $" << totalCost << std::endl;
+        std::cout << "Total Items: " << totalItems << std::endl;
+    }
+
 public:
-    ShoppingCart() : totalCost(0.0), totalItems(0) {}
+    ShoppingCart() : totalCost(), totalItems(0) {}
     
-    void addItem( AVLTree& inventory,  const std::string& upcCode, int quantity) {
+    void addItem(AVLTree& inventory, const std::string& upcCode, int quantity) {
+        UpcKey key;
+        if (!UpcKey::parse(upcCode, key)) {
+            std::cout << "Invalid UPC code." << std::endl;
+            return;
+        }
+        addItem(inventory, key, quantity);
+    }
+    
+    // Take quantity units of upcCode from the inventory into the cart.
+    // Nothing is printed.
+    StockStatus tryAddItem(AVLTree& inventory, UpcKey upcCode, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
         GroceryItem* item = inventory.search(upcCode);
-        if (item == nullptr) {
+        if (item == nullptr) return StockStatus::NotFound;
+        return tryAddItem(inventory, *item, quantity);
+    }
+    
+    // Same, for an item search() already returned, so callers that keep
+    // the pointer skip the tree descent
+    StockStatus tryAddItem(AVLTree& inventory, GroceryItem& item, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        if (item.getQuantity() < quantity) return StockStatus::InsufficientStock;
+        // item points into the tree, so this is the only write needed
+        inventory.adjustStock(item, -quantity);
+        addToCart(item, quantity);
+        return StockStatus::Ok;
+    }
+    
+    void addItem( AVLTree& inventory,  UpcKey upcCode, int quantity) {
+        switch (tryAddItem(inventory, upcCode, quantity)) {
+        case StockStatus::Ok:
+            break;
+        case StockStatus::NotFound:
             std::cout << "Item not found in inventory." << std::endl;
-            return;
+            break;
+        case StockStatus::InvalidQuantity:
+            std::cout << "Quantity must be positive." << std::endl;
+            break;
+        case StockStatus::InsufficientStock:
+            std::cout << "Not enough stock available for "<< inventory.search(upcCode)->getName() << "." << std::endl;
+            break;
         }
-        if (item -> getQuantity() < quantity) {
-            std::cout << "Not enough stock available for"<< item ->getName() << "available."<< std::endl;
-            return;
+    }
+    
+    // Add a burst of scans (UPC, quantity) at once. The batch is sorted and
+    // repeated UPCs are combined, every UPC is resolved in one walk of the
+    // inventory tree, and stock is taken once per UPC. A UPC whose combined
+    // quantity is not on hand, or is more than an int holds, is rejected
+    // for all of its scans; other UPCs are still added. Nothing is printed.
+    BatchScanResult addItems(AVLTree& inventory, const std::pair<UpcKey, int>* scans, size_t count) {
+        BatchScanResult result{std::vector<StockStatus>(count, StockStatus::InvalidQuantity), 0, 0};
+        
+        std::vector<uint32_t>& order = batchOrder;
+        order.clear();
+        for (size_t i = 0; i < count; ++i) {
+            if (scans[i].second > 0) order.push_back(static_cast<uint32_t>(i));
         }
-        item -> setQuantity(item -> getQuantity() - quantity);
-        inventory.update(upcCode, *item);
-
-        for (GroceryItem& cartItem : items) {
-            if (cartItem.getUpcCode() == upcCode) {
-                cartItem.setQuantity(cartItem.getQuantity() + quantity);
-                totalCost += item->getPrice() * quantity;
-                totalItems += quantity;
-                return;
+        // Ties broken by position, so each UPC's scans keep their order
+        std::sort(order.begin(), order.end(), [scans](uint32_t a, uint32_t b) {
+            return scans[a].first < scans[b].first || (scans[a].first == scans[b].first && a < b);
+        });
+        
+        // One entry per distinct UPC; runStart[k] is where its scans begin in order
+        std::vector<UpcKey>& keys = batchKeys;
+        std::vector<int64_t>& quantities = batchQuantities;
+        std::vector<size_t>& runStart = batchRunStart;
+        keys.clear();
+        quantities.clear();
+        runStart.clear();
+        for (size_t i = 0; i < order.size(); ++i) {
+            const std::pair<UpcKey, int>& scan = scans[order[i]];
+            if (keys.empty() || keys.back() != scan.first) {
+                keys.push_back(scan.first);
+                quantities.push_back(0);
+                runStart.push_back(i);
             }
+            quantities.back() += scan.second;
+        }
+        runStart.push_back(order.size());
+        
+        std::vector<GroceryItem*>& found = batchFound;
+        found.resize(keys.size());
+        inventory.searchSorted(keys.data(), keys.size(), found.data());
+        
+        lines.reserve(lines.size() + keys.size());
+        lineIndex.reserve(lines.size() + keys.size());
+        for (size_t k = 0; k < keys.size(); ++k) {
+            GroceryItem* item = found[k];
+            StockStatus status = StockStatus::Ok;
+            if (quantities[k] > INT_MAX) {
+                status = StockStatus::InvalidQuantity;
+            } else if (item == nullptr) {
+                status = StockStatus::NotFound;
+            } else if (item->getQuantity() < quantities[k]) {
+                status = StockStatus::InsufficientStock;
+            } else {
+                int quantity = static_cast<int>(quantities[k]);
+                inventory.adjustStock(*item, -quantity);
+                addToCart(*item, quantity);
+                result.accepted += runStart[k + 1] - runStart[k];
+                result.unitsAdded += quantities[k];
+            }
+            for (size_t i = runStart[k]; i < runStart[k + 1]; ++i) {
+                result.status[order[i]] = status;
+            }
+        }
+        return result;
+    }
+    
+    BatchScanResult addItems(AVLTree& inventory, const std::vector<std::pair<UpcKey, int>>& scans) {
+        return addItems(inventory, scans.data(), scans.size());
+    }
+    
+    // Thread-safe variant: the stock check and decrement happen atomically.
+    // A UPC already in the cart reuses its SkuHandle, so adding more of it
+    // touches only that SKU's stock counter. Nothing is printed.
+    StockStatus tryAddItem(ConcurrentInventory& inventory, UpcKey upcCode, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        long position = findLine(upcCode);
+        if (position >= 0) {
+            CartLine& line = lines[position];
+            if (!inventory.tryReserve(line.sku, quantity)) return StockStatus::InsufficientStock;
+            line.quantity += quantity;
+            totalCost += line.unitPrice * quantity;
+            totalItems += quantity;
+            return StockStatus::Ok;
+        }
+        
+        GroceryItem item;
+        StockStatus status = inventory.reserveStock(upcCode, quantity, item);
+        if (status == StockStatus::Ok) {
+            addToCart(item, quantity);
+        }
+        return status;
+    }
+    
+    // Variant for a VersionedInventory: every add commits a new version, so
+    // a snapshot sees the units either on the shelf or gone, never both.
+    // Nothing is printed.
+    StockStatus tryAddItem(VersionedInventory& inventory, UpcKey upcCode, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        GroceryItem item;
+        StockStatus status = inventory.reserveStock(upcCode, quantity, item);
+        if (status == StockStatus::Ok) {
+            addToCart(item, quantity);
+        }
+        return status;
+    }
+    
+    void addItem(ConcurrentInventory& inventory, UpcKey upcCode, int quantity) {
+        switch (tryAddItem(inventory, upcCode, quantity)) {
+        case StockStatus::Ok:
+            break;
+        case StockStatus::NotFound:
+            std::cout << "Item not found in inventory." << std::endl;
+            break;
+        case StockStatus::InvalidQuantity:
+            std::cout << "Quantity must be positive." << std::endl;
+            break;
+        case StockStatus::InsufficientStock:
+            std::cout << "Not enough stock available for UPC " << upcCode << "." << std::endl;
+            break;
         }
-        GroceryItem itemToAdd = *item;
-        itemToAdd.setQuantity(quantity);
-        items.push_back(itemToAdd);
-        totalCost += item->getPrice() * quantity;
-        totalItems += quantity; 
     }
     
     void removeItem(AVLTree& inventory, const std::string& upcCode, int quantity) {
-        GroceryItem* item = inventory.search(upcCode);
-        if (item == nullptr) {
+        UpcKey key;
+        if (!UpcKey::parse(upcCode, key)) {
+            std::cout << "Invalid UPC code." << std::endl;
+            return;
+        }
+        removeItem(inventory, key, quantity);
+    }
+    
+    void removeItem(AVLTree& inventory, UpcKey upcCode, int quantity) {
+        long position = findLine(upcCode);
+        if (position < 0) {
+            std::cout << "Item not found in cart." << std::endl;
+            return;
+        }
+        if (inventory.search(upcCode) == nullptr) {
             std::cout << "Item not found in inventory." << std::endl;
             return;
         }
-        for (auto it = items.begin(); it != items.end(); ++it) {
-            if (it->getUpcCode() == upcCode) {
-                if (it->getQuantity() < quantity) {
-                    std::cout << "Not enough items in cart to remove." << std::endl;
-                    return;
-                }
-                it->setQuantity(it->getQuantity() - quantity);
-                totalCost -= item->getPrice() * quantity;
-                totalItems -= quantity;
-                
-                if (it->getQuantity() == 0) {
-                    items.erase(it);
-                }
-                item->setQuantity(item->getQuantity() + quantity);
-                inventory.update(upcCode, *item);
-                return;
-            }
+        if (!takeFromLine(position, quantity)) {
+            std::cout << "Not enough items in cart to remove." << std::endl;
+            return;
         }
-        
-        std::cout << "Item not found in cart." << std::endl;
+        inventory.releaseStock(upcCode, quantity);
+    }
+    
+    void removeItem(ConcurrentInventory& inventory, UpcKey upcCode, int quantity) {
+        long position = findLine(upcCode);
+        if (position < 0) {
+            std::cout << "Item not found in cart." << std::endl;
+            return;
+        }
+        if (quantity <= 0 || lines[position].quantity < quantity) {
+            std::cout << "Not enough items in cart to remove." << std::endl;
+            return;
+        }
+        if (!inventory.release(lines[position].sku, quantity)) {
+            std::cout << "Item not found in inventory." << std::endl;
+            return;
+        }
+        takeFromLine(position, quantity);
     }
 
-    void displayCart() const {
+    // Names and aisles are looked up in the inventory the cart was filled from
+    void displayCart(const AVLTree& inventory) const {
         std::cout << std::fixed << std::setprecision(2);
-        for (const GroceryItem& item : items) {
-            std::cout << "UPC: " << item.getUpcCode() 
-                      << ", Name: " << item.getName() 
-                      << ", Price: $" << item.getPrice() 
-                      << ", Quantity: " << item.getQuantity() 
-                      << ", Aisle: " << item.getAisle() 
-                      << std::endl;
+        for (const CartLine& line : lines) {
+            printLine(line, inventory.search(line.upc));
         }
-        std::cout << "Total Cost: $" << totalCost << std::endl;
-        std::cout << "Total Items: " << totalItems << std::endl;
+        printTotals();
+    }
+    
+    void displayCart(const ConcurrentInventory& inventory) const {
+        std::cout << std::fixed << std::setprecision(2);
+        GroceryItem item;
+        for (const CartLine& line : lines) {
+            printLine(line, inventory.lookup(line.upc, item) ? &item : nullptr);
+        }
+        printTotals();
     }
+    
+    // Put every line's units back into the inventory and empty the cart
+    void returnToInventory(AVLTree& inventory) {
+        for (const CartLine& line : lines) {
+            inventory.releaseStock(line.upc, line.quantity);
+        }
+        clearCart();
+    }
+    
     void clearCart() {
-        items.clear();
-        totalCost = 0.0;
+        lines.clear();
+        lineIndex.clear();
+        totalCost = Money();
         totalItems = 0;
     }
-    double getTotalCost() const {
+    
+    // Lines in no particular order (removing a line moves the last one)
+    const std::vector<CartLine>& getLines() const {
+        return lines;
+    }
+    
+    // Quantity of a UPC in the cart (0 if absent)
+    int quantityOf(UpcKey upcCode) const {
+        long position = findLine(upcCode);
+        return position < 0 ? 0 : lines[position].quantity;
+    }
+    
+    bool isEmpty() const {
+        return lines.empty();
+    }
+    
+    Money getTotalCost() const {
         return totalCost;
     }
     int getTotalItems() const {
@@ -99,4 +370,4 @@ public:
     
 };
 
-#endif 
\ No newline at end of file
+#endif 
@@ -0,0 +1,120 @@
+#ifndef STOCK_LEDGER_H
+#define STOCK_LEDGER_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include "GroceryItem.h"
+
+// Stock levels for every SKU, kept apart from the catalog data in a dense
+// array of 32-bit atomic counters. A SkuHandle is a slot in this array; the
+// catalog resolves it once per UPC and the checkout path then only touches
+// that one counter.
+//
+// Counters live in fixed-size blocks reached through a fixed table, so
+// readers never see a block move, and slots are never reused: a removed SKU's
+// counter is retired (set negative) and any handle still pointing at it
+// simply stops granting stock.
+class StockLedger {
+private:
+    static constexpr unsigned kBlockBits = 16; // 65536 counters per block
+    static constexpr uint32_t kBlockSize = 1u << kBlockBits;
+    static constexpr size_t kMaxBlocks = 4096;
+    static constexpr int32_t kRetired = -1;
+
+    std::atomic<std::atomic<int32_t>*> blocks[kMaxBlocks];
+    std::mutex growLock;
+    uint32_t nextSlot;
+
+    std::atomic<int32_t>& counter(SkuHandle sku) const {
+        return blocks[sku >> kBlockBits].load(std::memory_order_acquire)[sku & (kBlockSize - 1)];
+    }
+
+public:
+    StockLedger() : nextSlot(0) {
+        for (auto& block : blocks) {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~StockLedger() {
+        for (auto& block : blocks) {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    StockLedger(const StockLedger&) = delete;
+    StockLedger& operator=(const StockLedger&) = delete;
+
+    // Hand out a new counter holding quantity. Returns kNoSku when full or
+    // when quantity is negative (a negative count would read as retired).
+    SkuHandle allocate(int32_t quantity) {
+        if (quantity < 0) return kNoSku;
+        std::lock_guard<std::mutex> lock(growLock);
+        if (nextSlot == kMaxBlocks * kBlockSize) {
+            return kNoSku;
+        }
+        SkuHandle sku = nextSlot++;
+        size_t block = sku >> kBlockBits;
+        if (blocks[block].load(std::memory_order_relaxed) == nullptr) {
+            blocks[block].store(new std::atomic<int32_t>[kBlockSize], std::memory_order_release);
+        }
+        counter(sku).store(quantity, std::memory_order_release);
+        return sku;
+    }
+
+    // Stop granting stock for a SKU that left the catalog
+    void retire(SkuHandle sku) {
+        counter(sku).store(kRetired, std::memory_order_release);
+    }
+
+    // Take n units if at least n are on hand; never lets the count go negative
+    bool tryReserve(SkuHandle sku, int32_t n) {
+        if (n <= 0) return false;
+        std::atomic<int32_t>& count = counter(sku);
+        int32_t current = count.load(std::memory_order_relaxed);
+        while (current >= n) {
+            if (count.compare_exchange_weak(current, current - n,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Give n units back. Fails if the SKU has been retired.
+    bool release(SkuHandle sku, int32_t n) {
+        if (n <= 0) return false;
+        std::atomic<int32_t>& count = counter(sku);
+        int32_t current = count.load(std::memory_order_relaxed);
+        while (current != kRetired) {
+            if (count.compare_exchange_weak(current, current + n,
+                                            std::memory_order_acq_rel,
+                                            std::memory_order_relaxed)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Overwrite the stock level (restock or manual correction). Rejects a
+    // negative quantity.
+    bool set(SkuHandle sku, int32_t quantity) {
+        if (quantity < 0) return false;
+        counter(sku).store(quantity, std::memory_order_release);
+        return true;
+    }
+
+    int32_t get(SkuHandle sku) const {
+        int32_t value = counter(sku).load(std::memory_order_acquire);
+        return value == kRetired ? 0 : value;
+    }
+
+    bool isRetired(SkuHandle sku) const {
+        return counter(sku).load(std::memory_order_acquire) == kRetired;
+    }
+};
+
+#endif
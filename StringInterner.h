@@ -0,0 +1,157 @@
+// StringInterner.h - Process-wide pool of interned strings
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef STRING_INTERNER_H
+#define STRING_INTERNER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Keeps one copy of every distinct string it is given and hands out a
+// 32-bit handle for it. Item names, aisles and customer names repeat
+// across every copy of an item and every transaction, so those hold a
+// handle instead of their own std::string.
+//
+// Strings are never released. Text lives in fixed arena chunks and the
+// handle table in fixed-size blocks reached through a fixed table, so
+// nothing a handle refers to ever moves and view() takes no lock.
+class StringInterner {
+private:
+    static constexpr unsigned kBlockBits = 16; // 65536 handles per block
+    static constexpr uint32_t kBlockSize = 1u << kBlockBits;
+    static constexpr size_t kMaxBlocks = 65536;
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    std::atomic<std::string_view*> blocks[kMaxBlocks];
+    std::unordered_map<std::string_view, uint32_t> handles;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    char* chunkFree;
+    size_t chunkLeft;
+    uint32_t nextHandle;
+    size_t arenaBytes;
+    mutable std::shared_mutex lock;
+
+    // Copy text into the arena; long strings get a chunk of their own
+    const char* store(std::string_view text) {
+        if (text.size() > chunkLeft) {
+            size_t size = text.size() > kChunkSize / 4 ? text.size() : kChunkSize;
+            chunks.emplace_back(new char[size]);
+            arenaBytes += size;
+            if (size != kChunkSize) {
+                std::memcpy(chunks.back().get(), text.data(), text.size());
+                return chunks.back().get();
+            }
+            chunkFree = chunks.back().get();
+            chunkLeft = kChunkSize;
+        }
+        char* copy = chunkFree;
+        std::memcpy(copy, text.data(), text.size());
+        chunkFree += text.size();
+        chunkLeft -= text.size();
+        return copy;
+    }
+
+    std::string_view& entry(uint32_t handle) const {
+        return blocks[handle >> kBlockBits].load(std::memory_order_acquire)[handle & (kBlockSize - 1)];
+    }
+
+public:
+    static constexpr uint32_t kEmpty = 0; // handle of ""
+
+    StringInterner() : chunkFree(nullptr), chunkLeft(0), nextHandle(1), arenaBytes(0) {
+        for (auto& block : blocks) {
+            block.store(nullptr, std::memory_order_relaxed);
+        }
+        blocks[0].store(new std::string_view[kBlockSize], std::memory_order_release);
+    }
+
+    ~StringInterner() {
+        for (auto& block : blocks) {
+            delete[] block.load(std::memory_order_relaxed);
+        }
+    }
+
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+
+    // The pool GroceryItem and Transaction use. Never destroyed, so
+    // handles held by other statics stay readable during shutdown.
+    static StringInterner& global() {
+        static StringInterner* pool = new StringInterner();
+        return *pool;
+    }
+
+    // Handle for text, adding it if it is new. Thread-safe; a string seen
+    // before costs one hash lookup under a shared lock.
+    uint32_t intern(std::string_view text) {
+        if (text.empty()) return kEmpty;
+        {
+            std::shared_lock<std::shared_mutex> reading(lock);
+            auto found = handles.find(text);
+            if (found != handles.end()) return found->second;
+        }
+        std::unique_lock<std::shared_mutex> writing(lock);
+        auto found = handles.find(text);
+        if (found != handles.end()) return found->second;
+        if (nextHandle == 0) return kEmpty; // all 2^32 handles taken
+        uint32_t handle = nextHandle++;
+        size_t block = handle >> kBlockBits;
+        if (blocks[block].load(std::memory_order_relaxed) == nullptr) {
+            blocks[block].store(new std::string_view[kBlockSize], std::memory_order_release);
+        }
+        std::string_view stored(store(text), text.size());
+        entry(handle) = stored;
+        handles.emplace(stored, handle);
+        return handle;
+    }
+
+    // Text of a handle from intern(); valid for the life of the process
+    std::string_view view(uint32_t handle) const {
+        return entry(handle);
+    }
+
+    size_t size() const {
+        std::shared_lock<std::shared_mutex> reading(lock);
+        return handles.size();
+    }
+
+    // Heap bytes held: arena chunks, handle blocks and the lookup table
+    size_t memoryUsage() const {
+        std::shared_lock<std::shared_mutex> reading(lock);
+        size_t bytes = arenaBytes;
+        bytes += ((nextHandle - 1) / kBlockSize + 1) * kBlockSize * sizeof(std::string_view);
+        bytes += handles.bucket_count() * sizeof(void*) +
+                 handles.size() * (sizeof(std::string_view) + sizeof(uint32_t) + 2 * sizeof(void*));
+        return bytes;
+    }
+};
+
+// A string held as a handle into StringInterner::global(). Copying one is
+// copying 4 bytes; equal strings have equal handles.
+class InternedString {
+private:
+    uint32_t id;
+
+public:
+    InternedString() : id(StringInterner::kEmpty) {}
+    explicit InternedString(std::string_view text) : id(StringInterner::global().intern(text)) {}
+
+    std::string_view view() const { return StringInterner::global().view(id); }
+    uint32_t handle() const { return id; }
+    bool empty() const { return id == StringInterner::kEmpty; }
+
+    friend bool operator==(InternedString a, InternedString b) { return a.id == b.id; }
+    friend bool operator!=(InternedString a, InternedString b) { return a.id != b.id; }
+    friend std::ostream& operator<<(std::ostream& out, InternedString text) { return out << text.view(); }
+};
+
+#endif // STRING_INTERNER_H
@@ -0,0 +1,170 @@
+// TransactionColumns.h - Column-oriented copy of the transaction history for analytics scans
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef TRANSACTION_COLUMNS_H
+#define TRANSACTION_COLUMNS_H
+
+#include <cstdint>
+#include <cstddef>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "UpcKey.h"
+#include "Money.h"
+
+// The numeric fields the sales figures read, each in its own contiguous
+// array, plus one flattened table of line items. A scan that sums totals
+// or counts units reads only the columns it needs instead of dragging
+// customer names, timestamps and full GroceryItem copies through the cache.
+class TransactionColumns {
+public:
+    static constexpr int64_t kNoTime = INT64_MIN; // unparseable timestamp
+
+private:
+    // One entry per transaction
+    std::vector<int64_t> times; // seconds since 1970-01-01, store-local clock
+    std::vector<int64_t> discounts; // amounts are in cents
+    std::vector<int64_t> taxes;
+    std::vector<int64_t> totals;
+
+    // One entry per line item
+    std::vector<UpcKey> lineUpc;
+    std::vector<int32_t> lineQuantity;
+
+    // Days since 1970-01-01 for a proleptic Gregorian date
+    static int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+        y -= m <= 2;
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        unsigned yoe = static_cast<unsigned>(y - era * 400);
+        unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<int64_t>(doe) - 719468;
+    }
+
+    static bool digits(std::string_view text, size_t from, size_t count, int& value) {
+        value = 0;
+        for (size_t i = from; i < from + count; ++i) {
+            if (text[i] < '0' || text[i] > '9') return false;
+            value = value * 10 + (text[i] - '0');
+        }
+        return true;
+    }
+
+public:
+    // Parse "YYYY-MM-DD HH:MM:SS" (or just the date) into seconds. The
+    // clock is taken as-is, without a time zone, so the date part
+    // round-trips exactly through dayKeyOf.
+    static int64_t parseTimestamp(std::string_view text) {
+        int year, month, day, hour = 0, minute = 0, second = 0;
+        if (text.size() < 10 || text[4] != '-' || text[7] != '-' ||
+            !digits(text, 0, 4, year) || !digits(text, 5, 2, month) || !digits(text, 8, 2, day)) {
+            return kNoTime;
+        }
+        if (month < 1 || month > 12 || day < 1 || day > 31) {
+            return kNoTime;
+        }
+        if (text.size() >= 19 && !(digits(text, 11, 2, hour) && digits(text, 14, 2, minute) &&
+                                   digits(text, 17, 2, second))) {
+            hour = minute = second = 0; // keep the date
+        }
+        return daysFromCivil(year, month, day) * 86400 + hour * 3600 + minute * 60 + second;
+    }
+
+    // YYYYMMDD of a parsed timestamp, or -1 for kNoTime (matches
+    // TransactionManager::dayKey)
+    static int dayKeyOf(int64_t time) {
+        if (time == kNoTime) return -1;
+        int64_t z = (time >= 0 ? time : time - 86399) / 86400 + 719468;
+        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        unsigned doe = static_cast<unsigned>(z - era * 146097);
+        unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        unsigned mp = (5 * doy + 2) / 153;
+        unsigned d = doy - (153 * mp + 2) / 5 + 1;
+        unsigned m = mp < 10 ? mp + 3 : mp - 9;
+        int64_t y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+        return static_cast<int>(y * 10000 + m * 100 + d);
+    }
+
+    // Append one transaction; lines is any range of (GroceryItem, quantity)
+    template <typename Lines>
+    void append(std::string_view timestamp, Money discount, Money tax, Money total, const Lines& lines) {
+        times.push_back(parseTimestamp(timestamp));
+        discounts.push_back(discount.getCents());
+        taxes.push_back(tax.getCents());
+        totals.push_back(total.getCents());
+        for (const auto& line : lines) {
+            lineUpc.push_back(line.first.getUpc());
+            lineQuantity.push_back(line.second);
+        }
+    }
+
+    void reserve(size_t transactions, size_t lines) {
+        times.reserve(transactions);
+        discounts.reserve(transactions);
+        taxes.reserve(transactions);
+        totals.reserve(transactions);
+        lineUpc.reserve(lines);
+        lineQuantity.reserve(lines);
+    }
+
+    void clear() {
+        times.clear();
+        discounts.clear();
+        taxes.clear();
+        totals.clear();
+        lineUpc.clear();
+        lineQuantity.clear();
+    }
+
+    size_t size() const { return totals.size(); }
+    size_t lineCount() const { return lineUpc.size(); }
+
+    // Column access for scans
+    const std::vector<int64_t>& timestamps() const { return times; }
+    const std::vector<int64_t>& discountColumn() const { return discounts; }
+    const std::vector<int64_t>& taxColumn() const { return taxes; }
+    const std::vector<int64_t>& totalColumn() const { return totals; }
+    const std::vector<UpcKey>& lineUpcs() const { return lineUpc; }
+    const std::vector<int32_t>& lineQuantities() const { return lineQuantity; }
+
+    // Sum of all totals
+    Money totalRevenue() const {
+        int64_t sum = 0;
+        for (int64_t total : totals) sum += total;
+        return Money::fromCents(sum);
+    }
+
+    // YYYYMMDD -> revenue
+    std::unordered_map<int, Money> revenueByDay() const {
+        std::unordered_map<int, Money> byDay;
+        int64_t currentDay = kNoTime;
+        Money* bucket = nullptr;
+        for (size_t i = 0; i < times.size(); ++i) {
+            int64_t day = times[i] == kNoTime ? kNoTime : (times[i] >= 0 ? times[i] : times[i] - 86399) / 86400;
+            if (bucket == nullptr || day != currentDay) {
+                currentDay = day;
+                bucket = &byDay[dayKeyOf(times[i])];
+            }
+            *bucket += Money::fromCents(totals[i]);
+        }
+        return byDay;
+    }
+
+    // Units sold per product
+    std::unordered_map<UpcKey, int64_t> unitsByProduct() const {
+        std::unordered_map<UpcKey, int64_t> units;
+        for (size_t i = 0; i < lineUpc.size(); ++i) {
+            units[lineUpc[i]] += lineQuantity[i];
+        }
+        return units;
+    }
+
+    // Heap bytes held by the columns
+    size_t memoryUsage() const {
+        return (times.capacity() + discounts.capacity() + taxes.capacity() + totals.capacity()) * sizeof(int64_t) +
+               lineUpc.capacity() * sizeof(UpcKey) + lineQuantity.capacity() * sizeof(int32_t);
+    }
+};
+
+#endif // TRANSACTION_COLUMNS_H
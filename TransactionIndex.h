@@ -0,0 +1,146 @@
+// TransactionIndex.h - Hash indexes over the transaction history
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef TRANSACTION_INDEX_H
+#define TRANSACTION_INDEX_H
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+// Open-addressing hash map from a 32-bit integer key to a 32-bit value,
+// using linear probing over a power-of-two table kept at most half full.
+// Entries are 8 bytes and sit inline in one array, so a lookup is usually
+// a single cache line. Keys are never removed (the history is append-only).
+class IntHashIndex {
+public:
+    static constexpr uint32_t npos = 0xFFFFFFFFu;
+
+private:
+    struct Slot {
+        int32_t key;
+        uint32_t value; // npos marks an empty slot
+    };
+
+    std::vector<Slot> slots;
+    size_t count;
+
+    size_t home(int32_t key) const {
+        uint32_t h = static_cast<uint32_t>(key) * 0x9E3779B1u; // Fibonacci hashing
+        return h & (slots.size() - 1);
+    }
+
+    void rehash(size_t newSize) {
+        std::vector<Slot> old;
+        old.swap(slots);
+        slots.assign(newSize, Slot{0, npos});
+        for (const Slot& slot : old) {
+            if (slot.value != npos) {
+                size_t i = home(slot.key);
+                while (slots[i].value != npos) i = (i + 1) & (slots.size() - 1);
+                slots[i] = slot;
+            }
+        }
+    }
+
+public:
+    IntHashIndex() : count(0) {}
+
+    // Size the table for n keys up front (bulk loads)
+    void reserve(size_t n) {
+        size_t needed = 16;
+        while (needed < n * 2) needed *= 2;
+        if (needed > slots.size()) rehash(needed);
+    }
+
+    // Add key -> value unless key is already present. Returns the value
+    // stored for key afterwards.
+    uint32_t insert(int32_t key, uint32_t value) {
+        if ((count + 1) * 2 > slots.size()) {
+            rehash(slots.empty() ? 16 : slots.size() * 2);
+        }
+        size_t i = home(key);
+        while (slots[i].value != npos) {
+            if (slots[i].key == key) return slots[i].value;
+            i = (i + 1) & (slots.size() - 1);
+        }
+        slots[i] = Slot{key, value};
+        count++;
+        return value;
+    }
+
+    // Value stored for key, or npos
+    uint32_t find(int32_t key) const {
+        if (slots.empty()) return npos;
+        size_t i = home(key);
+        while (slots[i].value != npos) {
+            if (slots[i].key == key) return slots[i].value;
+            i = (i + 1) & (slots.size() - 1);
+        }
+        return npos;
+    }
+
+    void clear() {
+        slots.clear();
+        count = 0;
+    }
+
+    size_t size() const { return count; }
+    size_t memoryUsage() const { return slots.capacity() * sizeof(Slot); }
+};
+
+// Lookup structures TransactionManager keeps next to its history vector:
+// transaction ID -> position, and customer ID -> positions of that
+// customer's transactions (a posting list, in history order).
+class TransactionIndex {
+private:
+    IntHashIndex byId;
+    IntHashIndex byCustomer; // customer ID -> posting list number
+    std::vector<std::vector<uint32_t>> postings;
+
+public:
+    // Record the transaction at position slot. The first transaction seen
+    // with a given ID keeps it.
+    void add(int transactionId, int customerId, uint32_t slot) {
+        byId.insert(transactionId, slot);
+        uint32_t list = byCustomer.insert(customerId, static_cast<uint32_t>(postings.size()));
+        if (list == postings.size()) {
+            postings.emplace_back();
+        }
+        postings[list].push_back(slot);
+    }
+
+    void reserve(size_t transactions) {
+        byId.reserve(transactions);
+    }
+
+    // Position of a transaction, or IntHashIndex::npos
+    uint32_t find(int transactionId) const {
+        return byId.find(transactionId);
+    }
+
+    // Positions of a customer's transactions (empty if none)
+    const std::vector<uint32_t>& forCustomer(int customerId) const {
+        static const std::vector<uint32_t> none;
+        uint32_t list = byCustomer.find(customerId);
+        return list == IntHashIndex::npos ? none : postings[list];
+    }
+
+    void clear() {
+        byId.clear();
+        byCustomer.clear();
+        postings.clear();
+    }
+
+    // Bytes of heap held by the indexes
+    size_t memoryUsage() const {
+        size_t bytes = byId.memoryUsage() + byCustomer.memoryUsage() +
+                       postings.capacity() * sizeof(std::vector<uint32_t>);
+        for (const std::vector<uint32_t>& list : postings) {
+            bytes += list.capacity() * sizeof(uint32_t);
+        }
+        return bytes;
+    }
+};
+
+#endif // TRANSACTION_INDEX_H
@@ -0,0 +1,300 @@
+// TransactionJournal.cpp - Implementation of the binary transaction journal
+// Part of CSC 307 Grocery Store Simulator project
+
+#include "TransactionJournal.h"
+#include "MappedFile.h"
+#include <array>
+#include <cstring>
+#include <filesystem>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+const char kMagic[4] = {'G', 'S', 'J', '1'};
+const size_t kHeaderSize = JournalWriter::kHeaderSize;
+const size_t kFrameSize = 8;                 // length + CRC
+const uint32_t kMaxRecordSize = 64u << 20;   // sanity bound for a corrupt length
+
+std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+const std::array<uint32_t, 256> crcTable = makeCrcTable();
+
+uint32_t readU32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+void writeU32(unsigned char* p, uint32_t value) {
+    p[0] = static_cast<unsigned char>(value);
+    p[1] = static_cast<unsigned char>(value >> 8);
+    p[2] = static_cast<unsigned char>(value >> 16);
+    p[3] = static_cast<unsigned char>(value >> 24);
+}
+
+} // namespace
+
+uint32_t crc32(const void* data, size_t length, uint32_t crc) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; ++i) {
+        crc = crcTable[(crc ^ bytes[i]) & 0xFFu] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+// ByteWriter
+
+void ByteWriter::putU16(uint16_t value) {
+    out.push_back(static_cast<unsigned char>(value));
+    out.push_back(static_cast<unsigned char>(value >> 8));
+}
+
+void ByteWriter::putU32(uint32_t value) {
+    unsigned char bytes[4];
+    writeU32(bytes, value);
+    out.insert(out.end(), bytes, bytes + 4);
+}
+
+void ByteWriter::putU64(uint64_t value) {
+    putU32(static_cast<uint32_t>(value));
+    putU32(static_cast<uint32_t>(value >> 32));
+}
+
+void ByteWriter::putF64(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    putU64(bits);
+}
+
+void ByteWriter::putString(std::string_view value) {
+    size_t length = value.size() > 0xFFFF ? 0xFFFF : value.size();
+    putU16(static_cast<uint16_t>(length));
+    out.insert(out.end(), value.begin(), value.begin() + length);
+}
+
+// ByteReader
+
+bool ByteReader::getU8(uint8_t& value) {
+    if (remaining() < 1) return false;
+    value = data[pos++];
+    return true;
+}
+
+bool ByteReader::getU16(uint16_t& value) {
+    if (remaining() < 2) return false;
+    value = static_cast<uint16_t>(data[pos] | (data[pos + 1] << 8));
+    pos += 2;
+    return true;
+}
+
+bool ByteReader::getU32(uint32_t& value) {
+    if (remaining() < 4) return false;
+    value = readU32(data + pos);
+    pos += 4;
+    return true;
+}
+
+bool ByteReader::getU64(uint64_t& value) {
+    if (remaining() < 8) return false;
+    value = static_cast<uint64_t>(readU32(data + pos)) |
+            (static_cast<uint64_t>(readU32(data + pos + 4)) << 32);
+    pos += 8;
+    return true;
+}
+
+bool ByteReader::getI32(int32_t& value) {
+    uint32_t raw;
+    if (!getU32(raw)) return false;
+    value = static_cast<int32_t>(raw);
+    return true;
+}
+
+bool ByteReader::getI64(int64_t& value) {
+    uint64_t raw;
+    if (!getU64(raw)) return false;
+    value = static_cast<int64_t>(raw);
+    return true;
+}
+
+bool ByteReader::getF64(double& value) {
+    uint64_t bits;
+    if (!getU64(bits)) return false;
+    std::memcpy(&value, &bits, sizeof value);
+    return true;
+}
+
+bool ByteReader::getString(std::string& value) {
+    std::string_view text;
+    if (!getString(text)) return false;
+    value.assign(text.data(), text.size());
+    return true;
+}
+
+bool ByteReader::getString(std::string_view& value) {
+    uint16_t length;
+    size_t start = pos;
+    if (!getU16(length)) return false;
+    if (remaining() < length) {
+        pos = start;
+        return false;
+    }
+    value = std::string_view(reinterpret_cast<const char*>(data + pos), length);
+    pos += length;
+    return true;
+}
+
+// JournalWriter
+
+bool JournalWriter::open(const std::string& path, uint64_t validLength) {
+    close();
+
+    std::error_code ec;
+    bool fresh = validLength < kHeaderSize;
+    if (fresh) {
+        validLength = 0;
+    }
+    if (std::filesystem::exists(path, ec) && std::filesystem::file_size(path, ec) != validLength) {
+        std::filesystem::resize_file(path, validLength, ec);
+        if (ec) return false;
+    }
+
+    file = std::fopen(path.c_str(), "ab");
+    if (file == nullptr) return false;
+
+    if (fresh) {
+        unsigned char header[kHeaderSize];
+        std::memcpy(header, kMagic, 4);
+        writeU32(header + 4, kFormatVersion);
+        if (std::fwrite(header, 1, kHeaderSize, file) != kHeaderSize) {
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool JournalWriter::append(const unsigned char* payload, size_t length) {
+    if (file == nullptr || length > kMaxRecordSize) return false;
+
+    // Frame header and payload go out in a single fwrite
+    frame.resize(kFrameSize + length);
+    writeU32(frame.data(), static_cast<uint32_t>(length));
+    writeU32(frame.data() + 4, crc32(payload, length));
+    if (length > 0) {
+        std::memcpy(frame.data() + kFrameSize, payload, length);
+    }
+    return std::fwrite(frame.data(), 1, frame.size(), file) == frame.size();
+}
+
+bool JournalWriter::flush() {
+    return file != nullptr && std::fflush(file) == 0;
+}
+
+bool JournalWriter::sync() {
+    if (!flush()) return false;
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#elif defined(__APPLE__)
+    return fsync(fileno(file)) == 0;
+#else
+    return fdatasync(fileno(file)) == 0;
+#endif
+}
+
+void JournalWriter::close() {
+    if (file != nullptr) {
+        std::fclose(file);
+        file = nullptr;
+    }
+}
+
+// JournalReader
+
+JournalReader::ScanResult JournalReader::index(const unsigned char* data, size_t size,
+                                               std::vector<RecordSpan>& spans) {
+    ScanResult result{true, false, 0, 0, false, 0};
+    spans.clear();
+
+    if (size < kHeaderSize) {
+        // An empty file (or a header cut short by a crash) is a journal
+        // with no records yet
+        result.headerValid = true;
+        result.truncatedTail = size != 0;
+        result.version = JournalWriter::kFormatVersion;
+        return result;
+    }
+    uint32_t version = readU32(data + 4);
+    if (std::memcmp(data, kMagic, 4) != 0 || version < JournalWriter::kOldestReadableVersion ||
+        version > JournalWriter::kFormatVersion) {
+        return result;
+    }
+    result.headerValid = true;
+    result.version = version;
+
+    size_t pos = kHeaderSize;
+    while (size - pos >= kFrameSize) {
+        uint32_t length = readU32(data + pos);
+        if (length > kMaxRecordSize || size - pos - kFrameSize < length) {
+            break;
+        }
+        RecordSpan span;
+        span.payload = data + pos + kFrameSize;
+        span.length = length;
+        span.checksum = readU32(data + pos + 4);
+        span.offset = pos;
+        pos += kFrameSize + length;
+        span.endOffset = pos;
+        spans.push_back(span);
+    }
+    result.records = spans.size();
+    result.validLength = pos;
+    result.truncatedTail = pos != size;
+    return result;
+}
+
+JournalReader::ScanResult JournalReader::scan(
+        const std::string& path,
+        const std::function<bool(const unsigned char*, size_t)>& onRecord) {
+    MappedFile file;
+    if (!file.open(path)) {
+        return ScanResult{false, false, 0, 0, false, 0};
+    }
+
+    std::vector<RecordSpan> spans;
+    ScanResult result = index(file.data(), file.size(), spans);
+    if (!result.headerValid) {
+        return result;
+    }
+
+    // A file cut short inside the header has no valid prefix; the writer
+    // must start it over with a fresh header
+    result.records = 0;
+    result.validLength = file.size() < kHeaderSize ? 0 : kHeaderSize;
+    for (const RecordSpan& span : spans) {
+        if (!span.verify()) {
+            result.truncatedTail = true;
+            return result;
+        }
+        result.validLength = span.endOffset;
+        result.records++;
+        if (!onRecord(span.payload, span.length)) {
+            return result;
+        }
+    }
+    return result;
+}
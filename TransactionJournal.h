@@ -0,0 +1,143 @@
+// TransactionJournal.h - Append-only binary journal used for the transaction log
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef TRANSACTION_JOURNAL_H
+#define TRANSACTION_JOURNAL_H
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// On-disk layout:
+//   file header : "GSJ1" magic, u32 format version
+//   record      : u32 payload length, u32 CRC-32 of payload, payload bytes
+// All integers are little-endian. A record whose length or CRC does not
+// check out marks the end of the journal (e.g. a write torn by a crash);
+// everything before it is still readable.
+
+// CRC-32 (IEEE 802.3, reflected), chainable through the crc argument
+uint32_t crc32(const void* data, size_t length, uint32_t crc = 0);
+
+// Little-endian encoder for record payloads
+class ByteWriter {
+private:
+    std::vector<unsigned char>& out;
+
+public:
+    explicit ByteWriter(std::vector<unsigned char>& buffer) : out(buffer) {}
+
+    void putU8(uint8_t value) { out.push_back(value); }
+    void putU16(uint16_t value);
+    void putU32(uint32_t value);
+    void putU64(uint64_t value);
+    void putI32(int32_t value) { putU32(static_cast<uint32_t>(value)); }
+    void putI64(int64_t value) { putU64(static_cast<uint64_t>(value)); }
+    void putF64(double value);
+    void putString(std::string_view value); // u16 length + bytes
+};
+
+// Bounds-checked little-endian decoder; every get returns false once the
+// payload runs out, leaving the output untouched.
+class ByteReader {
+private:
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+
+public:
+    ByteReader(const unsigned char* bytes, size_t length) : data(bytes), size(length), pos(0) {}
+
+    bool getU8(uint8_t& value);
+    bool getU16(uint16_t& value);
+    bool getU32(uint32_t& value);
+    bool getU64(uint64_t& value);
+    bool getI32(int32_t& value);
+    bool getI64(int64_t& value);
+    bool getF64(double& value);
+    bool getString(std::string& value);
+    bool getString(std::string_view& value); // points into the payload
+
+    size_t remaining() const { return size - pos; }
+};
+
+// Keeps the journal open for the life of the process and appends framed
+// records through a buffered stdio handle.
+class JournalWriter {
+private:
+    std::FILE* file;
+    std::vector<unsigned char> frame;
+
+public:
+    // Version written into new journals; readers also accept anything
+    // back to kOldestReadableVersion (record payloads differ by version)
+    static constexpr uint32_t kFormatVersion = 2;
+    static constexpr uint32_t kOldestReadableVersion = 1;
+    // Bytes before the first record; a journal no longer than this is empty
+    static constexpr size_t kHeaderSize = 8;
+
+    JournalWriter() : file(nullptr) {}
+    ~JournalWriter() { close(); }
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    // Open (or create) a journal for appending. validLength is the size of
+    // the readable prefix as reported by JournalReader::scan; anything after
+    // it (a torn tail) is cut off before new records are written. An
+    // existing journal must already be at kFormatVersion.
+    bool open(const std::string& path, uint64_t validLength);
+
+    bool append(const unsigned char* payload, size_t length);
+    bool append(const std::vector<unsigned char>& payload) {
+        return append(payload.data(), payload.size());
+    }
+
+    // Hand buffered records to the operating system
+    bool flush();
+
+    // flush() plus an fdatasync so the records survive a power loss
+    bool sync();
+
+    void close();
+    bool isOpen() const { return file != nullptr; }
+};
+
+class JournalReader {
+public:
+    // One framed record inside a mapped journal
+    struct RecordSpan {
+        const unsigned char* payload;
+        uint32_t length;
+        uint32_t checksum;
+        uint64_t offset;    // file offset of the frame
+        uint64_t endOffset; // file offset just past this record
+
+        bool verify() const { return crc32(payload, length) == checksum; }
+    };
+
+    struct ScanResult {
+        bool opened;          // false if the file does not exist / cannot be read
+        bool headerValid;     // false if the file is not a journal of a known version
+        size_t records;       // records delivered to the callback
+        uint64_t validLength; // bytes up to the end of the last good record
+        bool truncatedTail;   // true if garbage or a partial record followed
+        uint32_t version;     // format version from the header (0 if unknown)
+    };
+
+    // Call onRecord for every intact record in file order. Returning false
+    // from the callback stops the scan early.
+    static ScanResult scan(const std::string& path,
+                           const std::function<bool(const unsigned char*, size_t)>& onRecord);
+
+    // Walk the frames of an in-memory (typically mmapped) journal without
+    // copying payloads or checking CRCs, so callers can verify and decode
+    // the spans in parallel. validLength/truncatedTail describe the framing
+    // only; a span that later fails verify() ends the journal there.
+    static ScanResult index(const unsigned char* data, size_t size, std::vector<RecordSpan>& spans);
+};
+
+#endif // TRANSACTION_JOURNAL_H
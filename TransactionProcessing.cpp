@@ -2,56 +2,192 @@
 // Part of CSC 307 Grocery Store Simulator project
 
 #include "TransactionProcessing.h"
+#include "MappedFile.h"
+#include "AggregationKernels.h"
+#include "LoaderUtil.h"
 #include <sstream>
 #include <chrono>
 #include <iomanip>
 #include <ctime>
 #include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <thread>
 
-// Helper function to get current timestamp
-std::string Transaction::getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    std::time_t time = std::chrono::system_clock::to_time_t(now);
+namespace {
+
+// Dollar amount as written by the old CSV log: normally "12.34", but the
+// default stream formatting could also produce forms like "1e+06"
+bool parseAmount(std::string_view field, Money& value) {
+    if (Money::parse(field, value)) {
+        return true;
+    }
+    double dollars;
+    if (!parseNumber(field, dollars)) {
+        return false;
+    }
+    value = Money::fromDouble(dollars);
+    return true;
+}
+
+// Parse one legacy CSV line:
+//   id,customerId,name,subtotal,discount,tax,total,timestamp,UPC,Qty,Price;UPC,Qty,Price;...
+bool parseCsvLine(std::string_view line, std::vector<Transaction>& out) {
+    if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
     
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+    int transId, custId;
+    Money subtotal, discount, tax, total;
+    if (!parseNumber(nextField(line, ','), transId) || !parseNumber(nextField(line, ','), custId)) {
+        return false;
+    }
+    std::string_view custName = nextField(line, ',');
+    if (!parseAmount(nextField(line, ','), subtotal) || !parseAmount(nextField(line, ','), discount) ||
+        !parseAmount(nextField(line, ','), tax) || !parseAmount(nextField(line, ','), total)) {
+        return false;
+    }
+    std::string_view timestamp = nextField(line, ',');
+    if (timestamp.empty()) {
+        return false;
+    }
+    
+    // The rest of the line is the item list
+    std::vector<std::pair<GroceryItem, int>> items;
+    while (!line.empty()) {
+        std::string_view itemData = nextField(line, ';');
+        std::string_view upcText = nextField(itemData, ',');
+        std::string_view quantityText = nextField(itemData, ',');
+        std::string_view priceText = nextField(itemData, ',');
+        
+        UpcKey upc;
+        int quantity;
+        Money price;
+        if (UpcKey::parse(upcText, upc) && parseNumber(quantityText, quantity) &&
+            parseAmount(priceText, price)) {
+            // Create a simplified item (without name and aisle)
+            std::string name = "Item #";
+            name.append(upcText);
+            items.emplace_back(GroceryItem(name, upc, price, 0, ""), quantity);
+        }
+    }
+    
+    out.emplace_back(transId, custId, InternedString(custName), std::move(items),
+                     subtotal, discount, tax, total, timestamp);
+    return true;
+}
+
+// Read a dollar amount: integer cents since format version 2, a double
+// in version 1 journals
+bool getAmount(ByteReader& reader, uint32_t version, Money& value) {
+    if (version >= 2) {
+        int64_t cents;
+        if (!reader.getI64(cents)) return false;
+        value = Money::fromCents(cents);
+    } else {
+        double dollars;
+        if (!reader.getF64(dollars)) return false;
+        value = Money::fromDouble(dollars);
+    }
+    return true;
+}
+
+// Decode one journal record payload written in the given format version
+bool decodeTransaction(const unsigned char* data, size_t size, uint32_t version,
+                       std::vector<Transaction>& out) {
+    ByteReader reader(data, size);
+    int32_t transId, custId;
+    std::string_view custName, timestamp;
+    Money subtotal, discount, tax, total;
+    uint32_t itemCount;
+    
+    if (!reader.getI32(transId) || !reader.getI32(custId) || !reader.getString(custName) ||
+        !getAmount(reader, version, subtotal) || !getAmount(reader, version, discount) ||
+        !getAmount(reader, version, tax) || !getAmount(reader, version, total) ||
+        !reader.getString(timestamp) || !reader.getU32(itemCount)) {
+        return false;
+    }
+    
+    std::vector<std::pair<GroceryItem, int>> items;
+    items.reserve(std::min<size_t>(itemCount, reader.remaining()));
+    for (uint32_t i = 0; i < itemCount; ++i) {
+        uint64_t upc;
+        int32_t quantity;
+        Money price;
+        std::string_view name;
+        if (!reader.getU64(upc) || !reader.getI32(quantity) || !getAmount(reader, version, price) ||
+            !reader.getString(name)) {
+            return false;
+        }
+        items.emplace_back(GroceryItem(name, UpcKey::fromRaw(upc), price, 0, ""), quantity);
+    }
+    
+    out.emplace_back(transId, custId, InternedString(custName), std::move(items),
+                     subtotal, discount, tax, total, timestamp);
+    return true;
+}
+
+} // namespace
+
+// Copy ts into the inline buffer, cutting it off if it does not fit
+void Transaction::setTimestamp(std::string_view ts) {
+    timestampLength = static_cast<uint8_t>(std::min(ts.size(), kMaxTimestampLength));
+    std::memcpy(timestamp, ts.data(), timestampLength);
+    timestamp[timestampLength] = '\0';
+}
+
+// Format the current local time straight into the inline buffer
+void Transaction::stampCurrentTime() {
+    // localtime is slow (glibc rereads the zone file), so sales within the
+    // same second reuse the last formatted stamp
+    thread_local std::time_t lastSecond = -1;
+    thread_local char lastStamp[sizeof timestamp];
+    thread_local uint8_t lastLength = 0;
+    std::time_t now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    if (now != lastSecond) {
+        lastLength = static_cast<uint8_t>(
+            std::strftime(lastStamp, sizeof lastStamp, "%Y-%m-%d %H:%M:%S", std::localtime(&now)));
+        lastSecond = now;
+    }
+    std::memcpy(timestamp, lastStamp, lastLength);
+    timestampLength = lastLength;
+    timestamp[timestampLength] = '\0';
 }
 
 // Constructor for new transactions
-Transaction::Transaction(int id, int custId, std::string custName, 
-            const std::vector<std::pair<GroceryItem, int>>& cartItems,
-            double subt, double disc, double tx, double tot)
+Transaction::Transaction(int id, int custId, InternedString custName, 
+            std::vector<std::pair<GroceryItem, int>> cartItems,
+            Money subt, Money disc, Money tx, Money tot)
     : transactionId(id), customerId(custId), customerName(custName),
-      items(cartItems), subtotal(subt), discount(disc), tax(tx), total(tot) {
-    timestamp = getCurrentTimestamp();
+      items(std::move(cartItems)), subtotal(subt), discount(disc), tax(tx), total(tot) {
+    stampCurrentTime();
 }
 
 // Constructor for loading transactions from file
-Transaction::Transaction(int id, int custId, std::string custName, 
-            const std::vector<std::pair<GroceryItem, int>>& cartItems,
-            double subt, double disc, double tx, double tot, 
-            const std::string& ts)
+Transaction::Transaction(int id, int custId, InternedString custName, 
+            std::vector<std::pair<GroceryItem, int>> cartItems,
+            Money subt, Money disc, Money tx, Money tot, 
+            std::string_view ts)
     : transactionId(id), customerId(custId), customerName(custName),
-      items(cartItems), subtotal(subt), discount(disc), tax(tx), total(tot),
-      timestamp(ts) {
+      items(std::move(cartItems)), subtotal(subt), discount(disc), tax(tx), total(tot) {
+    setTimestamp(ts);
 }
 
 // Getters
 int Transaction::getTransactionId() const { return transactionId; }
 int Transaction::getCustomerId() const { return customerId; }
-std::string Transaction::getCustomerName() const { return customerName; }
+std::string_view Transaction::getCustomerName() const { return customerName.view(); }
 const std::vector<std::pair<GroceryItem, int>>& Transaction::getItems() const { return items; }
-double Transaction::getSubtotal() const { return subtotal; }
-double Transaction::getDiscount() const { return discount; }
-double Transaction::getTax() const { return tax; }
-double Transaction::getTotal() const { return total; }
-std::string Transaction::getTimestamp() const { return timestamp; }
+Money Transaction::getSubtotal() const { return subtotal; }
+Money Transaction::getDiscount() const { return discount; }
+Money Transaction::getTax() const { return tax; }
+Money Transaction::getTotal() const { return total; }
+std::string_view Transaction::getTimestamp() const { return std::string_view(timestamp, timestampLength); }
 
 // Display transaction details
 void Transaction::displayDetails() const {
     std::cout << "\n===== Transaction #" << transactionId << " =====\n";
-    std::cout << "Date/Time: " << timestamp << std::endl;
+    std::cout << "Date/Time: " << getTimestamp() << std::endl;
     std::cout << "Customer: " << customerName;
     if (customerId != -1) {
         std::cout << " (ID: " << customerId << ")";
@@ -61,7 +197,7 @@ void Transaction::displayDetails() const {
     std::cout << "Items purchased:\n";
     for (const auto& pair : items) {
         std::cout << "- " << pair.first.getName() 
-                  << " (UPC: " << pair.first.getUpcCode() << ")"
+                  << " (UPC: " << pair.first.getUpc() << ")"
                   << " x" << pair.second
                   << " @ $" << std::fixed << std::setprecision(2) << pair.first.getPrice()
                   << " = $" << std::fixed << std::setprecision(2) 
@@ -69,7 +205,7 @@ void Transaction::displayDetails() const {
     }
     
     std::cout << "\nSubtotal: $" << std::fixed << std::setprecision(2) << subtotal << std::endl;
-    if (discount > 0) {
+    if (discount > Money()) {
         std::cout << "Discount: -$" << std::fixed << std::setprecision(2) << discount << std::endl;
     }
     std::cout << "Tax: $" << std::fixed << std::setprecision(2) << tax << std::endl;
@@ -87,13 +223,13 @@ std::string Transaction::toCSV() const {
        << discount << ","
        << tax << ","
        << total << ","
-       << timestamp;
+       << getTimestamp();
        
     // Add items data (UPC,Quantity,Price;UPC,Quantity,Price;...)
     ss << ",";
     for (size_t i = 0; i < items.size(); ++i) {
         if (i > 0) ss << ";";
-        ss << items[i].first.getUpcCode() << "," 
+        ss << items[i].first.getUpc() << "," 
            << items[i].second << "," 
            << items[i].first.getPrice();
     }
@@ -101,113 +237,288 @@ std::string Transaction::toCSV() const {
     return ss.str();
 }
 
+// Convert transaction to the binary journal record format
+void Transaction::appendBinary(std::vector<unsigned char>& out) const {
+    ByteWriter writer(out);
+    writer.putI32(transactionId);
+    writer.putI32(customerId);
+    writer.putString(customerName.view());
+    writer.putI64(subtotal.getCents());
+    writer.putI64(discount.getCents());
+    writer.putI64(tax.getCents());
+    writer.putI64(total.getCents());
+    writer.putString(getTimestamp());
+    
+    // Amounts are integer cents. Items: UPC, quantity, unit price, name
+    writer.putU32(static_cast<uint32_t>(items.size()));
+    for (const auto& item : items) {
+        writer.putU64(item.first.getUpc().raw());
+        writer.putI32(item.second);
+        writer.putI64(item.first.getPrice().getCents());
+        writer.putString(item.first.getName());
+    }
+}
+
 // TransactionManager constructor
-TransactionManager::TransactionManager(const std::string& logFile) 
-    : nextTransactionId(1000), transactionLogFile(logFile) {
-    loadFromFile();
+TransactionManager::TransactionManager(const std::string& logFile, const std::string& legacyCsvFile,
+                                       const GroupCommitOptions& durability) 
+    : revenueTotal(), nextTransactionId(1000), transactionLogFile(logFile),
+      legacyCsvFile(legacyCsvFile) {
+    if (loadFromFile() && journal.isOpen()) {
+        commitLog.start(&journal, durability);
+    }
+}
+
+TransactionManager::~TransactionManager() {
+    commitLog.stop();
 }
 
-// Save transactions to file
+bool TransactionManager::flush() {
+    return commitLog.flush();
+}
+
+// Queue the most recent transaction for the journal writer thread
 bool TransactionManager::saveToFile() {
-    std::ofstream file(transactionLogFile, std::ios::app); // Append mode
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open transaction log file for writing.\n";
+    if (!commitLog.isRunning() || transactions.empty()) {
         return false;
     }
     
-    // Only write the most recent transaction
-    if (!transactions.empty()) {
-        file << transactions.back().toCSV() << std::endl;
+    recordBuffer.clear();
+    transactions.back().appendBinary(recordBuffer);
+    return commitLog.submit(recordBuffer);
+}
+
+// Keep a transaction read back from disk and advance the ID counter past
+// it. Loaders call rebuildSummaries() once they are done.
+void TransactionManager::recordLoaded(Transaction&& transaction) {
+    if (transaction.getTransactionId() >= nextTransactionId) {
+        nextTransactionId = transaction.getTransactionId() + 1;
+    }
+    transactions.push_back(std::move(transaction));
+}
+
+// Fold one transaction (stored at position slot) into the indexes and
+// the running aggregates
+void TransactionManager::summarize(const Transaction& transaction, size_t slot) {
+    index.add(transaction.getTransactionId(), transaction.getCustomerId(),
+              static_cast<uint32_t>(slot));
+    columns.append(transaction.getTimestamp(), transaction.getDiscount(), transaction.getTax(),
+                   transaction.getTotal(), transaction.getItems());
+    revenueTotal += transaction.getTotal();
+    revenueByDay[TransactionColumns::dayKeyOf(columns.timestamps().back())] += transaction.getTotal();
+    for (const auto& item : transaction.getItems()) {
+        if (salesSketch) {
+            salesSketch->record(item.first, item.second);
+        } else {
+            productSales.record(item.first, item.second);
+        }
+    }
+}
+
+// Build the indexes and aggregates over the whole history in one pass
+void TransactionManager::rebuildSummaries() {
+    size_t lines = 0;
+    for (const Transaction& transaction : transactions) {
+        lines += transaction.getItems().size();
+    }
+    columns.clear();
+    columns.reserve(transactions.size(), lines);
+    index.clear();
+    index.reserve(transactions.size());
+    revenueTotal = Money();
+    revenueByDay.clear();
+    productSales.clear();
+    if (salesSketch) salesSketch->clear();
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        summarize(transactions[i], i);
+    }
+}
+
+// Load all transactions from the journal, importing the legacy CSV log
+// the first time the journal is created. The journal is mapped into memory,
+// its frames are indexed in one quick pass, and the records are then
+// CRC-checked and decoded in parallel chunks.
+bool TransactionManager::loadFromFile() {
+    transactions.clear();
+    nextTransactionId = 1000; // Default starting ID
+    
+    MappedFile file;
+    std::vector<JournalReader::RecordSpan> spans;
+    JournalReader::ScanResult scan{false, false, 0, 0, false, 0};
+    if (file.open(transactionLogFile)) {
+        scan = JournalReader::index(file.data(), file.size(), spans);
     }
     
+    if (scan.opened && !scan.headerValid) {
+        std::cerr << "Error: " << transactionLogFile << " is not a transaction journal; "
+                  << "transactions will not be saved.\n";
+        return false;
+    }
+    
+    // Each part decodes a contiguous run of records and stops at the first
+    // record whose CRC fails; the earliest such failure ends the journal.
+    size_t parts = std::min(loaderThreadsFor(file.size()), std::max<size_t>(spans.size(), 1));
+    std::vector<std::vector<Transaction>> decoded(parts);
+    std::vector<size_t> firstBad(parts, spans.size());
+    std::vector<size_t> malformed(parts, 0);
+    runParallel(parts, [&](size_t part) {
+        size_t begin = spans.size() * part / parts;
+        size_t end = spans.size() * (part + 1) / parts;
+        decoded[part].reserve(end - begin);
+        for (size_t i = begin; i < end; ++i) {
+            if (!spans[i].verify()) {
+                firstBad[part] = i;
+                return;
+            }
+            if (!decodeTransaction(spans[i].payload, spans[i].length, scan.version, decoded[part])) {
+                malformed[part]++;
+            }
+        }
+    });
+    
+    size_t skipped = 0;
+    transactions.reserve(spans.size());
+    for (size_t part = 0; part < parts; ++part) {
+        for (Transaction& transaction : decoded[part]) {
+            recordLoaded(std::move(transaction));
+        }
+        skipped += malformed[part];
+        if (firstBad[part] != spans.size()) {
+            scan.truncatedTail = true;
+            scan.validLength = spans[firstBad[part]].offset;
+            break;
+        }
+    }
     file.close();
+    rebuildSummaries();
+    
+    if (skipped > 0) {
+        std::cerr << "Warning: Skipped " << skipped << " malformed transaction record(s).\n";
+    }
+    if (scan.truncatedTail) {
+        std::cerr << "Warning: Discarding incomplete record at the end of "
+                  << transactionLogFile << ".\n";
+    }
+    
+    if (scan.opened && scan.version < JournalWriter::kFormatVersion &&
+        !upgradeJournal(scan.validLength)) {
+        std::cerr << "Error: Could not upgrade " << transactionLogFile
+                  << " to the current journal format.\n";
+        return false;
+    }
+    
+    if (!journal.open(transactionLogFile, scan.validLength)) {
+        std::cerr << "Error: Could not open transaction log file for writing.\n";
+        return false;
+    }
+    
+    // It's not an error if neither file exists yet
+    if (!scan.opened && !legacyCsvFile.empty()) {
+        MappedFile legacy;
+        if (legacy.open(legacyCsvFile)) {
+            legacy.close();
+            return importFromCSV(legacyCsvFile);
+        }
+    }
     return true;
 }
 
-// Load all transactions from file
-bool TransactionManager::loadFromFile() {
-    std::ifstream file(transactionLogFile);
-    if (!file.is_open()) {
-        // It's not an error if the file doesn't exist yet
-        return true;
+// Rewrite the loaded history in the current journal format. The new
+// journal is written beside the old one and renamed over it once synced,
+// so a crash part way through leaves the old journal intact.
+bool TransactionManager::upgradeJournal(uint64_t& newLength) {
+    std::string upgraded = transactionLogFile + ".upgrade";
+    JournalWriter writer;
+    if (!writer.open(upgraded, 0)) {
+        return false;
+    }
+    for (const Transaction& transaction : transactions) {
+        recordBuffer.clear();
+        transaction.appendBinary(recordBuffer);
+        if (!writer.append(recordBuffer)) {
+            return false;
+        }
     }
+    if (!writer.sync()) {
+        return false;
+    }
+    writer.close();
     
-    transactions.clear();
-    nextTransactionId = 1000; // Default starting ID
+    std::error_code ec;
+    newLength = std::filesystem::file_size(upgraded, ec);
+    if (ec) {
+        return false;
+    }
+    std::filesystem::rename(upgraded, transactionLogFile, ec);
+    return !ec;
+}
+
+// Import an old-style CSV log and append its transactions to the journal
+bool TransactionManager::importFromCSV(const std::string& csvFile) {
+    size_t firstNew = transactions.size();
+    if (!loadFromCSV(csvFile)) {
+        return false;
+    }
     
-    std::string line;
-    while (std::getline(file, line)) {
-        // Parse transaction CSV data
-        std::istringstream iss(line);
-        std::string token;
-        std::vector<std::string> tokens;
-        
-        // Split by commas
-        while (std::getline(iss, token, ',')) {
-            tokens.push_back(token);
+    for (size_t i = firstNew; i < transactions.size(); ++i) {
+        recordBuffer.clear();
+        transactions[i].appendBinary(recordBuffer);
+        if (!journal.append(recordBuffer)) {
+            std::cerr << "Error: Could not write to transaction log file.\n";
+            return false;
         }
-        
-        // Need at least the basic transaction data plus items
-        if (tokens.size() >= 9) {
-            int transId = std::stoi(tokens[0]);
-            int custId = std::stoi(tokens[1]);
-            std::string custName = tokens[2];
-            double subtotal = std::stod(tokens[3]);
-            double discount = std::stod(tokens[4]);
-            double tax = std::stod(tokens[5]);
-            double total = std::stod(tokens[6]);
-            std::string timestamp = tokens[7];
-            
-            // Parse items (UPC,Quantity,Price;UPC,Quantity,Price;...)
-            std::vector<std::pair<GroceryItem, int>> items;
-            std::istringstream itemsStream(tokens[8]);
-            std::string itemData;
-            
-            while (std::getline(itemsStream, itemData, ';')) {
-                std::istringstream itemStream(itemData);
-                std::string itemToken;
-                std::vector<std::string> itemTokens;
-                
-                while (std::getline(itemStream, itemToken, ',')) {
-                    itemTokens.push_back(itemToken);
-                }
-                
-                if (itemTokens.size() >= 3) {
-                    int upc = std::stoi(itemTokens[0]);
-                    int quantity = std::stoi(itemTokens[1]);
-                    double price = std::stod(itemTokens[2]);
-                    
-                    // Create a simplified item (without name and aisle)
-                    GroceryItem item(upc, "Item #" + std::to_string(upc), price, 0, "");
-                    items.push_back(std::make_pair(item, quantity));
-                }
-            }
-            
-            // Create and add the transaction
-            Transaction transaction(transId, custId, custName, items, 
-                                   subtotal, discount, tax, total, timestamp);
-            transactions.push_back(transaction);
-            
-            // Update next transaction ID if needed
-            if (transId >= nextTransactionId) {
-                nextTransactionId = transId + 1;
+    }
+    return journal.sync();
+}
+
+// Parse a CSV log (one transaction per line). The mapped file is cut into
+// one chunk per thread at line boundaries and the chunks are parsed in
+// parallel, then appended in file order.
+bool TransactionManager::loadFromCSV(const std::string& csvFile) {
+    MappedFile file;
+    if (!file.open(csvFile)) {
+        return false;
+    }
+    
+    std::string_view text = file.view();
+    size_t parts = loaderThreadsFor(text.size());
+    std::vector<size_t> bounds = splitAtLines(text, parts);
+    
+    std::vector<std::vector<Transaction>> parsed(parts);
+    runParallel(parts, [&](size_t part) {
+        std::string_view chunk = text.substr(bounds[part], bounds[part + 1] - bounds[part]);
+        while (!chunk.empty()) {
+            std::string_view line = nextField(chunk, '\n');
+            if (!line.empty()) {
+                parseCsvLine(line, parsed[part]);
             }
         }
-    }
+    });
     
-    file.close();
+    size_t total = transactions.size();
+    for (const std::vector<Transaction>& part : parsed) {
+        total += part.size();
+    }
+    transactions.reserve(total);
+    for (std::vector<Transaction>& part : parsed) {
+        for (Transaction& transaction : part) {
+            recordLoaded(std::move(transaction));
+        }
+        std::vector<Transaction>().swap(part);
+    }
+    rebuildSummaries();
     return true;
 }
 
 // Add a new transaction
-int TransactionManager::addTransaction(int customerId, const std::string& customerName,
-                  const std::vector<std::pair<GroceryItem, int>>& items,
-                  double subtotal, double discount, double tax, double total) {
+int TransactionManager::addTransaction(int customerId, InternedString customerName,
+                  std::vector<std::pair<GroceryItem, int>> items,
+                  Money subtotal, Money discount, Money tax, Money total) {
     int transactionId = nextTransactionId++;
     
-    Transaction transaction(transactionId, customerId, customerName,
-                           items, subtotal, discount, tax, total);
-    transactions.push_back(transaction);
+    transactions.emplace_back(transactionId, customerId, customerName,
+                              std::move(items), subtotal, discount, tax, total);
+    summarize(transactions.back(), transactions.size() - 1);
     
     // Save the transaction to file
     saveToFile();
@@ -217,21 +528,20 @@ int TransactionManager::addTransaction(int customerId, const std::string& custom
 
 // Find a transaction by ID
 const Transaction* TransactionManager::findTransaction(int transactionId) const {
-    for (const auto& transaction : transactions) {
-        if (transaction.getTransactionId() == transactionId) {
-            return &transaction;
-        }
+    uint32_t slot = index.find(transactionId);
+    if (slot == IntHashIndex::npos) {
+        return nullptr;
     }
-    return nullptr;
+    return &transactions[slot];
 }
 
 // Get transactions by customer ID
 std::vector<const Transaction*> TransactionManager::getTransactionsByCustomer(int customerId) const {
+    const std::vector<uint32_t>& slots = index.forCustomer(customerId);
     std::vector<const Transaction*> result;
-    for (const auto& transaction : transactions) {
-        if (transaction.getCustomerId() == customerId) {
-            result.push_back(&transaction);
-        }
+    result.reserve(slots.size());
+    for (uint32_t slot : slots) {
+        result.push_back(&transactions[slot]);
     }
     return result;
 }
@@ -241,25 +551,103 @@ const std::vector<Transaction>& TransactionManager::getAllTransactions() const {
     return transactions;
 }
 
-// Get the total revenue
-double TransactionManager::getTotalRevenue() const {
-    double total = 0.0;
-    for (const auto& transaction : transactions) {
-        total += transaction.getTotal();
+// Column view of the history
+const TransactionColumns& TransactionManager::getColumns() const {
+    return columns;
+}
+
+// Heap bytes used by the lookup indexes
+size_t TransactionManager::getIndexMemoryUsage() const {
+    return index.memoryUsage();
+}
+
+// Bytes held by the Transaction objects and their item copies. Names and
+// aisles are interned handles and timestamps are inline, so nothing else
+// is on the heap.
+size_t TransactionManager::getRowMemoryUsage() const {
+    size_t bytes = transactions.capacity() * sizeof(Transaction);
+    for (const Transaction& transaction : transactions) {
+        bytes += transaction.getItems().capacity() * sizeof(std::pair<GroceryItem, int>);
     }
-    return total;
+    return bytes;
 }
 
-// Get the total revenue for a specific day
-double TransactionManager::getDailyRevenue(const std::string& date) const {
-    double total = 0.0;
-    for (const auto& transaction : transactions) {
-        // Check if the transaction date matches (format: YYYY-MM-DD HH:MM:SS)
-        if (transaction.getTimestamp().substr(0, 10) == date) {
-            total += transaction.getTotal();
+// Bytes held by the column store
+size_t TransactionManager::getColumnMemoryUsage() const {
+    return columns.memoryUsage();
+}
+
+// Get the total revenue
+Money TransactionManager::getTotalRevenue() const {
+    return revenueTotal;
+}
+
+// Get the total revenue for a specific day (format: YYYY-MM-DD)
+Money TransactionManager::getDailyRevenue(const std::string& date) const {
+    auto day = revenueByDay.find(dayKey(date));
+    return day == revenueByDay.end() ? Money() : day->second;
+}
+
+// Get the best-selling products
+std::vector<ProductSales> TransactionManager::getTopSellers(size_t k) const {
+    return salesSketch ? salesSketch->topK(k) : productSales.topK(k);
+}
+
+// Switch best-seller tracking to a bounded-memory sketch
+void TransactionManager::useApproximateTopSellers(size_t memoryBudget, size_t maxK) {
+    salesSketch.reset(new HeavyHittersSketch(memoryBudget, maxK));
+    rebuildSummaries();
+}
+
+// Parse the leading YYYY-MM-DD of a date or timestamp into YYYYMMDD
+int TransactionManager::dayKey(std::string_view date) {
+    return TransactionColumns::dayKeyOf(TransactionColumns::parseTimestamp(date));
+}
+
+// Recompute every aggregate from the Transaction rows themselves and
+// compare with the running values and with the same figures scanned from
+// the columns (amounts are integer cents, so they must match exactly)
+bool TransactionManager::verifyAggregates() const {
+    if (columns.size() != transactions.size()) {
+        return false;
+    }
+    const std::vector<int64_t>& totals = columns.totalColumn();
+    Money revenue;
+    std::unordered_map<int, Money> byDay;
+    std::unordered_map<UpcKey, int64_t> units;
+    for (size_t i = 0; i < transactions.size(); ++i) {
+        const Transaction& transaction = transactions[i];
+        if (totals[i] != transaction.getTotal().getCents() ||
+            findTransaction(transaction.getTransactionId()) == nullptr) {
+            return false;
         }
+        revenue += transaction.getTotal();
+        byDay[dayKey(transaction.getTimestamp())] += transaction.getTotal();
+        for (const auto& item : transaction.getItems()) {
+            units[item.first.getUpc()] += item.second;
+        }
+    }
+    if (revenue != revenueTotal || byDay != revenueByDay) {
+        return false;
     }
-    return total;
+    if (columns.totalRevenue() != revenue || columns.revenueByDay() != byDay ||
+        columns.unitsByProduct() != units) {
+        return false;
+    }
+    // Exact best-seller counts; the sketch only promises estimates
+    if (!salesSketch) {
+        std::vector<ProductSales> tracked = productSales.topK(productSales.productCount());
+        if (tracked.size() != units.size()) {
+            return false;
+        }
+        for (const ProductSales& product : tracked) {
+            auto found = units.find(product.upc);
+            if (found == units.end() || found->second != product.units) {
+                return false;
+            }
+        }
+    }
+    return true;
 }
 
 // Get the number of transactions
@@ -268,11 +656,48 @@ size_t TransactionManager::getTransactionCount() const {
 }
 
 // Get the average transaction value
-double TransactionManager::getAverageTransactionValue() const {
+Money TransactionManager::getAverageTransactionValue() const {
     if (transactions.empty()) {
-        return 0.0;
+        return Money();
     }
-    return getTotalRevenue() / transactions.size();
+    return revenueTotal.dividedBy(static_cast<int64_t>(transactions.size()));
+}
+
+// Get the total tax collected
+Money TransactionManager::getTotalTax() const {
+    const std::vector<int64_t>& taxes = columns.taxColumn();
+    return Money::fromCents(sumColumn(taxes.data(), taxes.size()));
+}
+
+// Get the total discount given
+Money TransactionManager::getTotalDiscount() const {
+    const std::vector<int64_t>& discounts = columns.discountColumn();
+    return Money::fromCents(sumColumn(discounts.data(), discounts.size()));
+}
+
+// Get the revenue between two timestamps (YYYY-MM-DD [HH:MM:SS]),
+// including from and excluding to
+Money TransactionManager::getRevenueBetween(const std::string& from, const std::string& to) const {
+    int64_t start = TransactionColumns::parseTimestamp(from);
+    int64_t end = TransactionColumns::parseTimestamp(to);
+    if (start == TransactionColumns::kNoTime || end == TransactionColumns::kNoTime) {
+        return Money();
+    }
+    const std::vector<int64_t>& totals = columns.totalColumn();
+    return Money::fromCents(sumInTimeRange(totals.data(), columns.timestamps().data(),
+                                           totals.size(), start, end));
+}
+
+// Get the smallest and largest transaction totals
+bool TransactionManager::getTransactionValueRange(Money& smallest, Money& largest) const {
+    const std::vector<int64_t>& totals = columns.totalColumn();
+    int64_t low, high;
+    if (!minMaxColumn(totals.data(), totals.size(), low, high)) {
+        return false;
+    }
+    smallest = Money::fromCents(low);
+    largest = Money::fromCents(high);
+    return true;
 }
 
 // Display all transactions
@@ -288,7 +713,7 @@ void TransactionManager::displayAllTransactions() const {
 }
 
 // Generate a sales report
-void TransactionManager::generateSalesReport() const {
+void TransactionManager::generateSalesReport(size_t topSellers) const {
     if (transactions.empty()) {
         std::cout << "No transaction data available for report.\n";
         return;
@@ -298,46 +723,35 @@ void TransactionManager::generateSalesReport() const {
     std::cout << "Total Transactions: " << getTransactionCount() << std::endl;
     std::cout << "Total Revenue: $" << std::fixed << std::setprecision(2) << getTotalRevenue() << std::endl;
     std::cout << "Average Transaction Value: $" << std::fixed << std::setprecision(2) << getAverageTransactionValue() << std::endl;
+    std::cout << "Tax Collected: $" << std::fixed << std::setprecision(2) << getTotalTax() << std::endl;
+    std::cout << "Discounts Given: $" << std::fixed << std::setprecision(2) << getTotalDiscount() << std::endl;
     
-    // Get today's date in YYYY-MM-DD format
-    auto now = std::chrono::system_clock::now();
-    std::time_t time = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time), "%Y-%m-%d");
-    std::string today = ss.str();
+    Money smallest, largest;
+    if (getTransactionValueRange(smallest, largest)) {
+        std::cout << "Smallest / Largest Transaction: $" << std::fixed << std::setprecision(2) << smallest
+                  << " / $" << largest << std::endl;
+    }
+    
+    // Local date daysFromToday days away, in YYYY-MM-DD format
+    auto dateFromToday = [](int daysFromToday) {
+        auto when = std::chrono::system_clock::now() + std::chrono::hours(24 * daysFromToday);
+        std::time_t time = std::chrono::system_clock::to_time_t(when);
+        std::stringstream ss;
+        ss << std::put_time(std::localtime(&time), "%Y-%m-%d");
+        return ss.str();
+    };
+    std::string today = dateFromToday(0);
     
     std::cout << "Today's Revenue: $" << std::fixed << std::setprecision(2) << getDailyRevenue(today) << std::endl;
+    // A date range is a filtered sum over the total and timestamp columns
+    std::cout << "Last 7 Days Revenue: $" << std::fixed << std::setprecision(2)
+              << getRevenueBetween(dateFromToday(-6), dateFromToday(1)) << std::endl;
     
     // Product popularity report
-    std::map<int, std::pair<std::string, int>> productSales; // UPC -> (Name, Quantity)
-    for (const auto& transaction : transactions) {
-        for (const auto& item : transaction.getItems()) {
-            if (productSales.find(item.first.getUpcCode()) == productSales.end()) {
-                productSales[item.first.getUpcCode()] = std::make_pair(item.first.getName(), 0);
-            }
-            productSales[item.first.getUpcCode()].second += item.second;
-        }
-    }
-    
     std::cout << "\nTop Selling Products:\n";
-    
-    // Convert map to vector for sorting
-    std::vector<std::pair<int, std::pair<std::string, int>>> productVector(
-        productSales.begin(), productSales.end());
-    
-    // Sort by quantity sold (descending)
-    std::sort(productVector.begin(), productVector.end(),
-        [](const auto& a, const auto& b) {
-            return a.second.second > b.second.second;
-        });
-    
-    // Display top 5 products (or fewer if less than 5 exist)
-    int count = 0;
-    for (const auto& product : productVector) {
-        std::cout << product.second.first << " (UPC: " << product.first << "): "
-                  << product.second.second << " units sold\n";
-        
-        if (++count >= 5) break;
+    for (const ProductSales& product : getTopSellers(topSellers)) {
+        std::cout << product.name << " (UPC: " << product.upc << "): "
+                  << product.units << " units sold\n";
     }
     
     std::cout << "========================\n";
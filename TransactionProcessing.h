@@ -8,86 +8,172 @@
 #include <vector>
 #include <map>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 #include <fstream>
 #include "GroceryItem.h" 
+#include "StringInterner.h"
+#include "TransactionJournal.h"
+#include "GroupCommitLog.h"
+#include "TransactionIndex.h"
+#include "SalesAnalytics.h"
+#include "TransactionColumns.h"
+#include <memory>
 
-// Transaction class to track customer purchases
+// Transaction class to track customer purchases. Apart from the item
+// vector it owns no heap memory: the customer name is interned and the
+// timestamp is stored inline.
 class Transaction {
 private:
+    // "YYYY-MM-DD HH:MM:SS" takes 19; longer timestamps are cut off
+    static constexpr size_t kMaxTimestampLength = 31;
+    
     int transactionId;
     int customerId; // -1 for guest checkout
-    std::string customerName;
+    InternedString customerName;
     std::vector<std::pair<GroceryItem, int>> items; // Pairs of item and quantity
-    double subtotal;
-    double discount;
-    double tax;
-    double total;
-    std::string timestamp;
+    Money subtotal;
+    Money discount;
+    Money tax;
+    Money total;
+    char timestamp[kMaxTimestampLength + 1];
+    uint8_t timestampLength;
     
-    std::string getCurrentTimestamp();
+    void setTimestamp(std::string_view ts);
+    void stampCurrentTime();
     
 public:
-    // Constructor for new transactions
-    Transaction(int id, int custId, std::string custName, 
-                const std::vector<std::pair<GroceryItem, int>>& cartItems,
-                double subt, double disc, double tx, double tot);
+    // Constructor for new transactions, stamped with the current time.
+    // cartItems is taken by value; pass an rvalue to move it in.
+    Transaction(int id, int custId, InternedString custName, 
+                std::vector<std::pair<GroceryItem, int>> cartItems,
+                Money subt, Money disc, Money tx, Money tot);
     
     // Constructor for loading transactions from file
-    Transaction(int id, int custId, std::string custName, 
-                const std::vector<std::pair<GroceryItem, int>>& cartItems,
-                double subt, double disc, double tx, double tot, 
-                const std::string& ts);
+    Transaction(int id, int custId, InternedString custName, 
+                std::vector<std::pair<GroceryItem, int>> cartItems,
+                Money subt, Money disc, Money tx, Money tot, 
+                std::string_view ts);
     
     // Getters
     int getTransactionId() const;
     int getCustomerId() const;
-    std::string getCustomerName() const;
+    std::string_view getCustomerName() const;
     const std::vector<std::pair<GroceryItem, int>>& getItems() const;
-    double getSubtotal() const;
-    double getDiscount() const;
-    double getTax() const;
-    double getTotal() const;
-    std::string getTimestamp() const;
+    Money getSubtotal() const;
+    Money getDiscount() const;
+    Money getTax() const;
+    Money getTotal() const;
+    std::string_view getTimestamp() const;
     
     // Display and convert functions
     void displayDetails() const;
     std::string toCSV() const;
+    void appendBinary(std::vector<unsigned char>& out) const;
 };
 
 // TransactionManager to handle all transaction operations
 class TransactionManager {
 private:
     std::vector<Transaction> transactions;
+    TransactionColumns columns; // numeric fields of transactions, for scans
+    TransactionIndex index;
+    
+    // Running aggregates, updated on every add so report figures are O(1)
+    Money revenueTotal;
+    std::unordered_map<int, Money> revenueByDay; // YYYYMMDD -> revenue
+    ProductSalesTracker productSales;
+    std::unique_ptr<HeavyHittersSketch> salesSketch; // replaces productSales when set
+    
     int nextTransactionId;
     std::string transactionLogFile;
+    std::string legacyCsvFile;
+    JournalWriter journal;
+    GroupCommitLog commitLog;
+    std::vector<unsigned char> recordBuffer;
     
     // File I/O operations
     bool saveToFile();
     bool loadFromFile();
+    bool loadFromCSV(const std::string& csvFile);
+    // Append the transactions of an old-style CSV log to the journal.
+    // Writes the journal directly, so only loadFromFile may call it,
+    // before commitLog starts.
+    bool importFromCSV(const std::string& csvFile);
+    bool upgradeJournal(uint64_t& newLength);
+    void recordLoaded(Transaction&& transaction);
+    void summarize(const Transaction& transaction, size_t slot);
+    void rebuildSummaries();
     
 public:
-    // Constructor
-    TransactionManager(const std::string& logFile = "transactions.csv");
+    // Constructor. logFile is the binary journal; if it does not exist yet
+    // and legacyCsvFile does, the CSV history is imported into it.
+    TransactionManager(const std::string& logFile = "transactions.log",
+                       const std::string& legacyCsvFile = "transactions.csv",
+                       const GroupCommitOptions& durability = GroupCommitOptions());
+    
+    // Writes out and syncs anything still queued before the journal closes
+    ~TransactionManager();
     
-    // Add a new transaction
-    int addTransaction(int customerId, const std::string& customerName,
-                      const std::vector<std::pair<GroceryItem, int>>& items,
-                      double subtotal, double discount, double tax, double total);
+    TransactionManager(const TransactionManager&) = delete;
+    TransactionManager& operator=(const TransactionManager&) = delete;
+    
+    // Barrier: returns once every recorded transaction is on disk
+    bool flush();
+    
+    // Add a new transaction, built in place in the history. items is
+    // taken by value; pass an rvalue to move it in.
+    int addTransaction(int customerId, InternedString customerName,
+                      std::vector<std::pair<GroceryItem, int>> items,
+                      Money subtotal, Money discount, Money tax, Money total);
     
     // Find transactions
     const Transaction* findTransaction(int transactionId) const;
     std::vector<const Transaction*> getTransactionsByCustomer(int customerId) const;
     const std::vector<Transaction>& getAllTransactions() const;
     
+    // Column view of the history for analytics scans
+    const TransactionColumns& getColumns() const;
+    
+    // Heap bytes used by the ID and customer lookup indexes
+    size_t getIndexMemoryUsage() const;
+    
+    // Bytes held by the row objects vs. the column store. Names are not
+    // counted in either; they live once in StringInterner::global().
+    size_t getRowMemoryUsage() const;
+    size_t getColumnMemoryUsage() const;
+    
     // Analytics functions
-    double getTotalRevenue() const;
-    double getDailyRevenue(const std::string& date) const;
+    Money getTotalRevenue() const;
+    Money getDailyRevenue(const std::string& date) const;
     size_t getTransactionCount() const;
-    double getAverageTransactionValue() const;
+    Money getAverageTransactionValue() const;
+    
+    // Column scans (vectorized where the CPU allows)
+    Money getTotalTax() const;
+    Money getTotalDiscount() const;
+    Money getRevenueBetween(const std::string& from, const std::string& to) const; // [from, to)
+    bool getTransactionValueRange(Money& smallest, Money& largest) const;
+    
+    // Best sellers by units sold, best first (approximate once
+    // useApproximateTopSellers has been called)
+    std::vector<ProductSales> getTopSellers(size_t k) const;
+    
+    // Track best sellers with a fixed-size Count-Min sketch instead of an
+    // exact per-product table; for very large histories
+    void useApproximateTopSellers(size_t memoryBudget, size_t maxK);
+    
+    // Recompute the running aggregates from the transactions themselves
+    // and compare them, and the column scans, with the recount; selftest
+    // uses it to check the incremental bookkeeping
+    bool verifyAggregates() const;
+    
+    // YYYYMMDD key for a "YYYY-MM-DD..." date or timestamp, or -1
+    static int dayKey(std::string_view date);
     
     // Reporting functions
     void displayAllTransactions() const;
-    void generateSalesReport() const;
+    void generateSalesReport(size_t topSellers = 5) const;
 };
 
 #endif // TRANSACTION_PROCESSING_H
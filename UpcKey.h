@@ -0,0 +1,128 @@
+#ifndef UPC_KEY_H
+#define UPC_KEY_H
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+// Packed UPC/EAN/GTIN code. Up to 14 decimal digits are stored as an integer
+// together with the digit count, so "000123" and "123" stay distinct and
+// format back exactly as they were entered. Keys order numerically, which
+// lets the inventory compare UPCs with a single integer compare.
+class UpcKey {
+private:
+    static constexpr unsigned kLengthBits = 4;
+
+    uint64_t packed; // (digits << 4) | digit count; 0 means "no key"
+
+    UpcKey(uint64_t digits, unsigned length)
+        : packed((digits << kLengthBits) | length) {}
+
+public:
+    static constexpr size_t kMaxDigits = 14;
+
+    UpcKey() : packed(0) {}
+
+    // Parse a string of 1-14 decimal digits. Returns false (and leaves out
+    // untouched) on an empty string, a non-digit, or too many digits.
+    static bool parse(std::string_view text, UpcKey& out) {
+        if (text.empty() || text.size() > kMaxDigits) return false;
+        uint64_t digits = 0;
+        for (char c : text) {
+            if (c < '0' || c > '9') return false;
+            digits = digits * 10 + static_cast<uint64_t>(c - '0');
+        }
+        out = UpcKey(digits, static_cast<unsigned>(text.size()));
+        return true;
+    }
+
+    // Convenience wrapper; returns an empty key when text is not a valid UPC.
+    static UpcKey fromString(std::string_view text) {
+        UpcKey key;
+        parse(text, key);
+        return key;
+    }
+
+    static UpcKey fromRaw(uint64_t raw) {
+        UpcKey key;
+        key.packed = raw;
+        return key;
+    }
+
+    bool isValid() const { return packed != 0; }
+    uint64_t raw() const { return packed; }
+    uint64_t digits() const { return packed >> kLengthBits; }
+    unsigned length() const { return static_cast<unsigned>(packed & ((1u << kLengthBits) - 1)); }
+
+    // Write the zero-padded digits into buf (at least kMaxDigits chars).
+    // Returns the number of characters written; no terminator is added.
+    size_t format(char* buf) const {
+        unsigned n = length();
+        uint64_t value = digits();
+        for (unsigned i = n; i > 0; --i) {
+            buf[i - 1] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+        return n;
+    }
+
+    std::string toString() const {
+        char buf[kMaxDigits];
+        return std::string(buf, format(buf));
+    }
+
+    // GTIN-8, UPC-A (12), EAN-13 and GTIN-14 carry a mod-10 check digit in
+    // the last position. Other lengths (e.g. in-store codes) have none.
+    bool hasCheckDigit() const {
+        unsigned n = length();
+        return n == 8 || n == 12 || n == 13 || n == 14;
+    }
+
+    bool hasValidCheckDigit() const {
+        if (!hasCheckDigit()) return false;
+        uint64_t value = digits();
+        unsigned check = static_cast<unsigned>(value % 10);
+        return computeCheckDigit(value / 10) == check;
+    }
+
+    // Check digit for a GTIN body (all digits except the check digit):
+    // weights alternate 3,1,3,... starting from the rightmost body digit.
+    static unsigned computeCheckDigit(uint64_t body) {
+        unsigned sum = 0;
+        bool triple = true;
+        while (body > 0) {
+            unsigned d = static_cast<unsigned>(body % 10);
+            sum += triple ? d * 3 : d;
+            triple = !triple;
+            body /= 10;
+        }
+        return (10 - sum % 10) % 10;
+    }
+
+    bool operator==(const UpcKey& other) const { return packed == other.packed; }
+    bool operator!=(const UpcKey& other) const { return packed != other.packed; }
+    bool operator<(const UpcKey& other) const { return packed < other.packed; }
+    bool operator>(const UpcKey& other) const { return packed > other.packed; }
+    bool operator<=(const UpcKey& other) const { return packed <= other.packed; }
+    bool operator>=(const UpcKey& other) const { return packed >= other.packed; }
+
+    friend std::ostream& operator<<(std::ostream& os, const UpcKey& key) {
+        char buf[kMaxDigits];
+        return os.write(buf, static_cast<std::streamsize>(key.format(buf)));
+    }
+};
+
+namespace std {
+template <>
+struct hash<UpcKey> {
+    size_t operator()(const UpcKey& key) const {
+        // Fibonacci hashing spreads the sequential UPCs a store tends to use.
+        return static_cast<size_t>(key.raw() * 0x9E3779B97F4A7C15ull);
+    }
+};
+}
+
+#endif
@@ -0,0 +1,359 @@
+// VersionedInventory.h - Copy-on-write inventory with O(1) point-in-time snapshots
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef VERSIONED_INVENTORY_H
+#define VERSIONED_INVENTORY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "AVLTree.h"
+#include "GroceryItem.h"
+
+// A persistent AVL tree: nodes are never changed once built. A write copies
+// only the O(log n) nodes on the path to the item it touches and shares the
+// rest with the previous version, then publishes the new root. A reader that
+// holds a root therefore sees one fixed version of the whole inventory for as
+// long as it likes, with no lock, while checkouts keep committing new ones.
+//
+// Versions are reclaimed by reference count: a node goes away when neither
+// the live root nor any snapshot still reaches it, i.e. as soon as the last
+// reader of an old version lets go of its snapshot.
+//
+// Each node also carries the item count, units and stock value of its
+// subtree, so the totals of any version are read off its root in O(1).
+struct VersionNode;
+using VersionRef = std::shared_ptr<const VersionNode>;
+
+struct VersionNode {
+    GroceryItem item;
+    VersionRef left;
+    VersionRef right;
+    int height;
+    size_t count;      // items in this subtree
+    int64_t units;     // sum of quantities in this subtree
+    int64_t valueCents; // sum of price * quantity in this subtree
+
+    VersionNode(const GroceryItem& entry, VersionRef l, VersionRef r)
+        : item(entry), left(std::move(l)), right(std::move(r)) {
+        height = 1 + std::max(heightOf(left), heightOf(right));
+        count = 1;
+        units = item.getQuantity();
+        valueCents = (item.getPrice() * item.getQuantity()).getCents();
+        for (const VersionRef* child : {&left, &right}) {
+            if (*child) {
+                count += (*child)->count;
+                units += (*child)->units;
+                valueCents += (*child)->valueCents;
+            }
+        }
+    }
+
+    static int heightOf(const VersionRef& node) { return node ? node->height : 0; }
+};
+
+// One frozen version of the inventory. Cheap to copy; safe to read from any
+// number of threads at once.
+class InventorySnapshot {
+private:
+    VersionRef root;
+    uint64_t versionNumber;
+
+    static void printItem(const GroceryItem& item) {
+        std::cout << "UPC: " << item.getUpc()
+                  << ", Name: " << item.getName()
+                  << ", Price: $" << item.getPrice()
+                  << ", Quantity: " << item.getQuantity()
+                  << ", Aisle: " << item.getAisle() << std::endl;
+    }
+
+public:
+    InventorySnapshot() : versionNumber(0) {}
+    InventorySnapshot(VersionRef top, uint64_t version) : root(std::move(top)), versionNumber(version) {}
+
+    // Number of commits this version includes
+    uint64_t version() const { return versionNumber; }
+
+    size_t size() const { return root ? root->count : 0; }
+    bool isEmpty() const { return !root; }
+    int64_t totalUnits() const { return root ? root->units : 0; }
+    Money totalValue() const { return Money::fromCents(root ? root->valueCents : 0); }
+
+    // The item as of this version, or nullptr; valid while the snapshot lives
+    const GroceryItem* find(UpcKey upcCode) const {
+        const VersionNode* node = root.get();
+        while (node != nullptr) {
+            if (upcCode == node->item.getUpc()) return &node->item;
+            node = upcCode < node->item.getUpc() ? node->left.get() : node->right.get();
+        }
+        return nullptr;
+    }
+
+    // Call visit(item) for every item in UPC order
+    template <typename Visitor>
+    void forEachItem(Visitor visit) const {
+        const VersionNode* stack[96];
+        size_t depth = 0;
+        const VersionNode* node = root.get();
+        while (node != nullptr || depth > 0) {
+            while (node != nullptr) {
+                stack[depth++] = node;
+                node = node->left.get();
+            }
+            node = stack[--depth];
+            visit(node->item);
+            node = node->right.get();
+        }
+    }
+
+    void displayAllItems() const {
+        if (isEmpty()) {
+            std::cout << "Inventory is empty." << std::endl;
+            return;
+        }
+        std::cout << "-------- GROCERY INVENTORY --------" << std::endl;
+        forEachItem(printItem);
+        std::cout << "----------------------------------" << std::endl;
+    }
+};
+
+// Builds the next version from the current one. Every change is made on a
+// private root; nothing is visible to readers until the edit is committed.
+class InventoryEditor {
+private:
+    VersionRef root;
+
+    static VersionRef make(const GroceryItem& item, VersionRef left, VersionRef right) {
+        return std::make_shared<const VersionNode>(item, std::move(left), std::move(right));
+    }
+
+    // New node for item over left/right, rotating once or twice if the two
+    // sides differ in height by more than one
+    static VersionRef balanced(const GroceryItem& item, VersionRef left, VersionRef right) {
+        int hl = VersionNode::heightOf(left);
+        int hr = VersionNode::heightOf(right);
+        if (hl > hr + 1) {
+            if (VersionNode::heightOf(left->left) >= VersionNode::heightOf(left->right)) {
+                return make(left->item, left->left, make(item, left->right, std::move(right)));
+            }
+            const VersionRef& mid = left->right;
+            return make(mid->item, make(left->item, left->left, mid->left),
+                        make(item, mid->right, std::move(right)));
+        }
+        if (hr > hl + 1) {
+            if (VersionNode::heightOf(right->right) >= VersionNode::heightOf(right->left)) {
+                return make(right->item, make(item, std::move(left), right->left), right->right);
+            }
+            const VersionRef& mid = right->left;
+            return make(mid->item, make(item, std::move(left), mid->left),
+                        make(right->item, mid->right, right->right));
+        }
+        return make(item, std::move(left), std::move(right));
+    }
+
+    static VersionRef insertNode(const VersionRef& node, const GroceryItem& item, bool& added) {
+        if (!node) {
+            added = true;
+            return make(item, nullptr, nullptr);
+        }
+        if (item.getUpc() < node->item.getUpc()) {
+            VersionRef left = insertNode(node->left, item, added);
+            return added ? balanced(node->item, std::move(left), node->right) : node;
+        }
+        if (item.getUpc() > node->item.getUpc()) {
+            VersionRef right = insertNode(node->right, item, added);
+            return added ? balanced(node->item, node->left, std::move(right)) : node;
+        }
+        return node; // Duplicate UPC codes not allowed
+    }
+
+    static VersionRef removeMin(const VersionRef& node, GroceryItem& minItem) {
+        if (!node->left) {
+            minItem = node->item;
+            return node->right;
+        }
+        return balanced(node->item, removeMin(node->left, minItem), node->right);
+    }
+
+    static VersionRef removeNode(const VersionRef& node, UpcKey upcCode, bool& removed) {
+        if (!node) return node;
+        if (upcCode < node->item.getUpc()) {
+            VersionRef left = removeNode(node->left, upcCode, removed);
+            return removed ? balanced(node->item, std::move(left), node->right) : node;
+        }
+        if (upcCode > node->item.getUpc()) {
+            VersionRef right = removeNode(node->right, upcCode, removed);
+            return removed ? balanced(node->item, node->left, std::move(right)) : node;
+        }
+        removed = true;
+        if (!node->left) return node->right;
+        if (!node->right) return node->left;
+        GroceryItem successor;
+        VersionRef right = removeMin(node->right, successor);
+        return balanced(successor, node->left, std::move(right));
+    }
+
+    // Copy the path to upcCode with the item there replaced; the shape of
+    // the tree does not change, so no rebalancing is needed
+    static VersionRef replaceNode(const VersionRef& node, UpcKey upcCode, const GroceryItem& item) {
+        if (upcCode < node->item.getUpc()) {
+            return make(node->item, replaceNode(node->left, upcCode, item), node->right);
+        }
+        if (upcCode > node->item.getUpc()) {
+            return make(node->item, node->left, replaceNode(node->right, upcCode, item));
+        }
+        return make(item, node->left, node->right);
+    }
+
+    friend class VersionedInventory;
+    explicit InventoryEditor(VersionRef base) : root(std::move(base)) {}
+
+public:
+    const GroceryItem* find(UpcKey upcCode) const {
+        return InventorySnapshot(root, 0).find(upcCode);
+    }
+
+    // Create operation - Insert a grocery item
+    bool insert(const GroceryItem& item) {
+        if (!item.getUpc().isValid()) return false; // Items need a parseable UPC
+        bool added = false;
+        root = insertNode(root, item, added);
+        return added;
+    }
+
+    // Update operation - Replace an existing item
+    bool update(UpcKey upcCode, const GroceryItem& newItem) {
+        if (find(upcCode) == nullptr) return false;
+        GroceryItem entry = newItem;
+        entry.setUpc(upcCode); // the key cannot move within the tree
+        root = replaceNode(root, upcCode, entry);
+        return true;
+    }
+
+    // Delete operation - Remove an item by UPC code
+    bool remove(UpcKey upcCode) {
+        bool removed = false;
+        root = removeNode(root, upcCode, removed);
+        return removed;
+    }
+
+    // Take quantity units out of stock if that many are on hand. Whenever
+    // the item exists, seen receives it as it was before any units were taken.
+    StockStatus reserveStock(UpcKey upcCode, int quantity, GroceryItem& seen) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        const GroceryItem* item = find(upcCode);
+        if (item == nullptr) return StockStatus::NotFound;
+        seen = *item;
+        if (item->getQuantity() < quantity) return StockStatus::InsufficientStock;
+        GroceryItem entry = *item;
+        entry.setQuantity(entry.getQuantity() - quantity);
+        root = replaceNode(root, upcCode, entry);
+        return StockStatus::Ok;
+    }
+
+    // Put quantity units back into stock
+    StockStatus releaseStock(UpcKey upcCode, int quantity) {
+        if (quantity <= 0) return StockStatus::InvalidQuantity;
+        const GroceryItem* item = find(upcCode);
+        if (item == nullptr) return StockStatus::NotFound;
+        GroceryItem entry = *item;
+        entry.setQuantity(entry.getQuantity() + quantity);
+        root = replaceNode(root, upcCode, entry);
+        return StockStatus::Ok;
+    }
+};
+
+// The live inventory: writers take turns (one mutex) building and publishing
+// new versions; readers take snapshots without ever waiting on a writer.
+class VersionedInventory {
+private:
+    // A root together with its version number, published as one pointer
+    struct Version {
+        VersionRef root;
+        uint64_t number;
+    };
+
+    std::mutex writeLock;
+    std::shared_ptr<const Version> current; // read and written with std::atomic_load/store
+
+    // Caller holds writeLock
+    void publish(VersionRef root) {
+        uint64_t next = std::atomic_load(&current)->number + 1;
+        std::atomic_store(&current, std::shared_ptr<const Version>(new Version{std::move(root), next}));
+    }
+
+    static VersionRef buildBalanced(const std::vector<GroceryItem>& items, size_t lo, size_t hi) {
+        if (lo >= hi) return nullptr;
+        size_t mid = lo + (hi - lo) / 2;
+        return std::make_shared<const VersionNode>(items[mid], buildBalanced(items, lo, mid),
+                                                   buildBalanced(items, mid + 1, hi));
+    }
+
+public:
+    VersionedInventory() : current(new Version{nullptr, 0}) {}
+
+    VersionedInventory(const VersionedInventory&) = delete;
+    VersionedInventory& operator=(const VersionedInventory&) = delete;
+
+    // O(1) point-in-time view: one atomic load of the current version
+    InventorySnapshot snapshot() const {
+        std::shared_ptr<const Version> version = std::atomic_load(&current);
+        return InventorySnapshot(version->root, version->number);
+    }
+
+    // Run edit(InventoryEditor&) and publish everything it changed as one
+    // version, so no snapshot ever sees part of it. Returns edit's result.
+    template <typename Edit>
+    auto apply(Edit edit) -> decltype(edit(std::declval<InventoryEditor&>())) {
+        std::lock_guard<std::mutex> lock(writeLock);
+        InventoryEditor editor(std::atomic_load(&current)->root);
+        auto result = edit(editor);
+        publish(std::move(editor.root));
+        return result;
+    }
+
+    // Replace the whole inventory with items sorted by UPC (valid, distinct
+    // keys, as CatalogLoader prepares them), built bottom-up in O(n)
+    void assignSorted(const std::vector<GroceryItem>& items) {
+        std::lock_guard<std::mutex> lock(writeLock);
+        publish(buildBalanced(items, 0, items.size()));
+    }
+
+    bool insert(const GroceryItem& item) {
+        return apply([&](InventoryEditor& e) { return e.insert(item); });
+    }
+
+    bool update(UpcKey upcCode, const GroceryItem& newItem) {
+        return apply([&](InventoryEditor& e) { return e.update(upcCode, newItem); });
+    }
+
+    bool remove(UpcKey upcCode) {
+        return apply([&](InventoryEditor& e) { return e.remove(upcCode); });
+    }
+
+    StockStatus reserveStock(UpcKey upcCode, int quantity, GroceryItem& seen) {
+        return apply([&](InventoryEditor& e) { return e.reserveStock(upcCode, quantity, seen); });
+    }
+
+    StockStatus releaseStock(UpcKey upcCode, int quantity) {
+        return apply([&](InventoryEditor& e) { return e.releaseStock(upcCode, quantity); });
+    }
+
+    // Copy of the current item with its stock level
+    bool lookup(UpcKey upcCode, GroceryItem& out) const {
+        InventorySnapshot view = snapshot();
+        const GroceryItem* item = view.find(upcCode);
+        if (item == nullptr) return false;
+        out = *item;
+        return true;
+    }
+
+    size_t size() const { return snapshot().size(); }
+};
+
+#endif // VERSIONED_INVENTORY_H
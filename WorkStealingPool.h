@@ -0,0 +1,162 @@
+// WorkStealingPool.h - Thread pool with per-worker task queues and stealing
+// Part of CSC 307 Grocery Store Simulator project
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Every worker owns a deque of tasks. A task submitted from inside a task
+// goes onto the submitting worker's own deque, which that worker pops from
+// the back (newest first, so related work stays in cache). A worker whose
+// deque is empty steals from the front of another worker's deque (oldest
+// first). Tasks submitted from outside the pool are dealt round-robin.
+// Each deque has its own small lock; there is no shared central queue.
+class WorkStealingPool {
+public:
+    using Task = std::function<void()>;
+
+private:
+    struct Worker {
+        std::mutex lock;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    std::atomic<size_t> queued;     // tasks sitting in some deque
+    std::atomic<size_t> unfinished; // submitted and not yet finished
+    std::atomic<uint64_t> steals;
+    std::atomic<size_t> nextVictim;
+
+    std::mutex idleLock;
+    std::condition_variable workReady;
+    std::condition_variable allDone;
+    bool stopping;
+
+    // Which pool and worker the calling thread belongs to
+    struct Membership {
+        const WorkStealingPool* pool;
+        size_t worker;
+    };
+    static Membership& membership() {
+        static thread_local Membership self{nullptr, 0};
+        return self;
+    }
+
+    bool popOwn(size_t self, Task& task) {
+        Worker& worker = *workers[self];
+        std::lock_guard<std::mutex> guard(worker.lock);
+        if (worker.tasks.empty()) return false;
+        task = std::move(worker.tasks.back());
+        worker.tasks.pop_back();
+        return true;
+    }
+
+    bool steal(size_t self, Task& task) {
+        size_t count = workers.size();
+        for (size_t i = 1; i < count; ++i) {
+            Worker& victim = *workers[(self + i) % count];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty()) {
+                task = std::move(victim.tasks.front());
+                victim.tasks.pop_front();
+                steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void run(size_t self) {
+        membership() = Membership{this, self};
+        Task task;
+        while (true) {
+            if (popOwn(self, task) || steal(self, task)) {
+                queued.fetch_sub(1, std::memory_order_acq_rel);
+                task();
+                task = nullptr;
+                if (unfinished.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    std::lock_guard<std::mutex> guard(idleLock);
+                    allDone.notify_all();
+                }
+                continue;
+            }
+            std::unique_lock<std::mutex> guard(idleLock);
+            workReady.wait(guard, [this] {
+                return stopping || queued.load(std::memory_order_acquire) > 0;
+            });
+            if (stopping && queued.load(std::memory_order_acquire) == 0) return;
+        }
+    }
+
+public:
+    // threadCount 0 means one per hardware thread
+    explicit WorkStealingPool(size_t threadCount = 0)
+        : queued(0), unfinished(0), steals(0), nextVictim(0), stopping(false) {
+        if (threadCount == 0) threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+        for (size_t i = 0; i < threadCount; ++i) {
+            workers.push_back(std::make_unique<Worker>());
+        }
+        for (size_t i = 0; i < threadCount; ++i) {
+            threads.emplace_back(&WorkStealingPool::run, this, i);
+        }
+    }
+
+    // Finishes every queued task, then joins the workers
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+            stopping = true;
+        }
+        workReady.notify_all();
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(Task task) {
+        const Membership& self = membership();
+        size_t target = self.pool == this
+                            ? self.worker
+                            : nextVictim.fetch_add(1, std::memory_order_relaxed) % workers.size();
+        // Counted before the push so a thief can never take it below zero
+        unfinished.fetch_add(1, std::memory_order_acq_rel);
+        queued.fetch_add(1, std::memory_order_acq_rel);
+        {
+            Worker& worker = *workers[target];
+            std::lock_guard<std::mutex> guard(worker.lock);
+            worker.tasks.push_back(std::move(task));
+        }
+        {
+            std::lock_guard<std::mutex> guard(idleLock);
+        }
+        workReady.notify_one();
+    }
+
+    // Block until every submitted task (including tasks those tasks
+    // submitted) has finished. Must not be called from a worker.
+    void waitIdle() {
+        std::unique_lock<std::mutex> guard(idleLock);
+        allDone.wait(guard, [this] { return unfinished.load(std::memory_order_acquire) == 0; });
+    }
+
+    size_t threadCount() const { return threads.size(); }
+    uint64_t stealCount() const { return steals.load(std::memory_order_relaxed); }
+};
+
+#endif // WORK_STEALING_POOL_H
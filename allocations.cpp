@@ -0,0 +1,371 @@
+// allocations.cpp - Counts heap allocations on the checkout-to-log path
+// Part of CSC 307 Grocery Store Simulator project
+//
+//   allocations [--checkouts N] [--log FILE]
+//   allocations --history N [--log FILE]
+//
+// Replaces the global operator new with a counting one, runs warm-up
+// checkouts so every reused buffer has reached its working size, then
+// counts what a steady-state checkout still allocates. Exits with 1 if
+// any stage allocates more than its budget.
+//
+// --history records and reloads N transactions instead, and compares
+// their allocations and live heap with the same history held the old
+// way, as std::string copies of every name, aisle and timestamp.
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+#include "AVLTree.h"
+#include "CheckoutEngine.h"
+#include "ShoppingCart.h"
+#include "TransactionProcessing.h"
+
+namespace {
+
+// Each block carries its size in front so operator delete can keep
+// liveBytes current; 16 bytes keeps the block itself aligned for new
+const size_t kBlockHeader = 16;
+
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> allocatedBytes{0};
+std::atomic<size_t> liveBytes{0};
+std::atomic<bool> counting{false};
+
+} // namespace
+
+void* operator new(size_t size) {
+    char* block = static_cast<char*>(std::malloc(size + kBlockHeader));
+    if (block == nullptr) throw std::bad_alloc();
+    *reinterpret_cast<size_t*>(block) = size;
+    liveBytes.fetch_add(size, std::memory_order_relaxed);
+    if (counting.load(std::memory_order_relaxed)) {
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    }
+    return block + kBlockHeader;
+}
+
+// GCC inlines these into library code and then flags free() on memory
+// from operator new, and the header read in front of the block, not
+// seeing that this file supplies both sides
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#pragma GCC diagnostic ignored "-Warray-bounds"
+#endif
+void operator delete(void* block) noexcept {
+    if (block == nullptr) return;
+    char* start = static_cast<char*>(block) - kBlockHeader;
+    liveBytes.fetch_sub(*reinterpret_cast<size_t*>(start), std::memory_order_relaxed);
+    std::free(start);
+}
+void operator delete(void* block, size_t) noexcept { operator delete(block); }
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+namespace {
+
+const int kItems = 2000;
+const int kWarmUp = 50000;
+const int kLinesPerCart = 4;
+const int kHistoryItems = 5000;
+const int kCustomers = 2000;
+const char* const kAisles[] = {"Dairy", "Bakery", "Produce", "Meat & Seafood", "Frozen Foods",
+                               "Household Cleaning", "Beverages", "Snacks and Candy"};
+
+// Allocations and bytes counted while work() runs
+struct Count {
+    size_t allocations;
+    size_t bytes;
+};
+
+template <typename Work>
+Count countDuring(Work work) {
+    size_t before = allocations.load();
+    size_t bytesBefore = allocatedBytes.load();
+    counting.store(true);
+    work();
+    counting.store(false);
+    return Count{allocations.load() - before, allocatedBytes.load() - bytesBefore};
+}
+
+// count items named "Store Brand Product Number NNNNN", UPCs from 100000
+void buildInventory(AVLTree& inventory, int count, int aisles) {
+    for (int i = 0; i < count; ++i) {
+        char name[64];
+        std::snprintf(name, sizeof name, "Store Brand Product Number %05d", i);
+        inventory.insert(GroceryItem(name, UpcKey::fromRaw(100000 + i), Money::fromCents(100 + i), 1 << 30,
+                                     kAisles[i % aisles]));
+    }
+}
+
+// Fill the cart with the same mix of lines for checkout number t
+void fillCart(ShoppingCart& cart, AVLTree& inventory, int t) {
+    for (int k = 0; k < kLinesPerCart; ++k) {
+        cart.tryAddItem(inventory, UpcKey::fromRaw(100000 + (t * 7 + k * 131) % kItems), 1 + k);
+    }
+}
+
+// Print one stage and say whether it kept within budget allocations per checkout
+bool report(const char* stage, Count count, int checkouts, double budget, const char* note) {
+    double perCheckout = double(count.allocations) / checkouts;
+    bool ok = perCheckout <= budget;
+    std::cout << "  " << std::left << std::setw(26) << stage << std::right << std::setw(8)
+              << perCheckout << " allocations/checkout" << std::setw(10) << double(count.bytes) / checkouts
+              << " bytes  (budget " << budget << ", " << note << ")" << (ok ? "" : "  OVER BUDGET") << std::endl;
+    return ok;
+}
+
+// Price carts alone, then price and log them, then read the logged
+// history back, counting allocations per checkout at each stage
+bool countCheckouts(int checkouts, const std::string& logFile) {
+    AVLTree inventory;
+    buildInventory(inventory, kItems, 8);
+    bool ok = true;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << checkouts << " checkouts of " << kLinesPerCart << " lines after " << kWarmUp
+              << " warm-up:" << std::endl;
+    GroupCommitOptions durability;
+    durability.policy = DurabilityPolicy::Async;
+    TransactionManager manager(logFile, "", durability);
+    ShoppingCart cart;
+
+    // Pricing alone: the engine reuses its receipt buffers
+    CheckoutEngine pricing;
+    for (int t = 0; t < kWarmUp; ++t) {
+        fillCart(cart, inventory, t);
+        pricing.checkout(cart);
+    }
+    Count priced{0, 0};
+    for (int t = kWarmUp; t < kWarmUp + checkouts; ++t) {
+        fillCart(cart, inventory, t);
+        Count one = countDuring([&] { pricing.checkout(cart); });
+        priced.allocations += one.allocations;
+        priced.bytes += one.bytes;
+    }
+    ok &= report("price", priced, checkouts, 0, "receipt buffers are reused");
+
+    // Pricing and logging: the history keeps each transaction's lines
+    CheckoutEngine logging;
+    TransactionLogSink sink(manager, inventory, 7, "Loyalty Customer Seven");
+    logging.addSink(&sink);
+    for (int t = 0; t < kWarmUp; ++t) {
+        fillCart(cart, inventory, t);
+        logging.checkout(cart);
+    }
+    Count logged{0, 0};
+    auto start = std::chrono::steady_clock::now();
+    for (int t = kWarmUp; t < kWarmUp + checkouts; ++t) {
+        fillCart(cart, inventory, t);
+        Count one = countDuring([&] { logging.checkout(cart); });
+        logged.allocations += one.allocations;
+        logged.bytes += one.bytes;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    manager.flush();
+    ok &= report("price + log", logged, checkouts, 1.01,
+                 "one line array per stored transaction, plus amortized history growth");
+
+    // Reading every field of the history back hands out views, not copies
+    size_t characters = 0;
+    Count read = countDuring([&] {
+        for (const Transaction& transaction : manager.getAllTransactions()) {
+            characters += transaction.getCustomerName().size() + transaction.getTimestamp().size();
+            for (const auto& line : transaction.getItems()) {
+                characters += line.first.getName().size() + line.first.getAisle().size();
+            }
+        }
+    });
+    ok &= report("read history fields", read, static_cast<int>(manager.getTransactionCount()), 0,
+                 "views into the interned pool");
+    std::cout << "  " << seconds * 1e6 / checkouts << " us per logged checkout, "
+              << manager.getTransactionCount() << " transactions, " << characters << " characters read"
+              << std::endl;
+    return ok;
+}
+
+// An item and a transaction held the way they were before interning:
+// every copy carries its own strings
+struct StringItem {
+    std::string name;
+    UpcKey upc;
+    Money price;
+    int quantity;
+    std::string aisle;
+};
+
+struct StringTransaction {
+    int id;
+    int customerId;
+    std::string customerName;
+    std::vector<std::pair<StringItem, int>> items;
+    Money subtotal, discount, tax, total;
+    std::string timestamp;
+};
+
+// Customer of transaction t; every tenth is a guest
+int customerOf(int t) {
+    return t % 10 == 0 ? -1 : t % kCustomers;
+}
+
+// UPC of line k of transaction t
+UpcKey lineUpc(int t, int k) {
+    return UpcKey::fromRaw(100000 + (t * 7 + k * 131) % kHistoryItems);
+}
+
+void printHistoryLine(const char* what, size_t allocated, double seconds, size_t live, int transactions) {
+    std::cout << "  " << std::left << std::setw(24) << what << std::right << std::setw(7)
+              << double(allocated) / transactions << " allocations/transaction" << std::setw(8)
+              << seconds * 1e3 << " ms" << std::setw(9) << live / 1e6 << " MB live" << std::endl;
+}
+
+// Record a history of the given size twice, once as std::string copies
+// (the rows alone, built the old way: a Transaction copying its lines,
+// then pushed back by copy) and once through TransactionManager, which
+// also fills its columns, indexes and journal; then reload the journal
+void countHistory(int transactions, const std::string& logFile) {
+    std::vector<std::string> customers;
+    for (int i = 0; i < kCustomers; ++i) customers.push_back("Loyalty Customer " + std::to_string(i));
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << transactions << " transactions of " << kLinesPerCart << " lines, " << kHistoryItems
+              << " items, " << kCustomers << " customers:" << std::endl;
+
+    size_t heapCopies = 0;
+    {
+        std::vector<StringItem> catalog;
+        for (int i = 0; i < kHistoryItems; ++i) {
+            char name[64];
+            std::snprintf(name, sizeof name, "Store Brand Product Number %05d", i);
+            catalog.push_back(StringItem{name, UpcKey::fromRaw(100000 + i), Money::fromCents(100 + i), 1000,
+                                         kAisles[i % 8]});
+        }
+        size_t baseLive = liveBytes.load();
+        std::vector<StringTransaction> history;
+        std::vector<std::pair<StringItem, int>> lines;
+        size_t before = allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        counting.store(true);
+        for (int t = 0; t < transactions; ++t) {
+            lines.clear();
+            for (int k = 0; k < kLinesPerCart; ++k) {
+                lines.emplace_back(catalog[lineUpc(t, k).raw() - 100000], 1 + k);
+            }
+            int customer = customerOf(t);
+            StringTransaction transaction{t + 1, customer, customer < 0 ? "Guest" : customers[customer], lines,
+                                          Money::fromCents(1000), Money(), Money::fromCents(80),
+                                          Money::fromCents(1080), "2024-03-01 12:00:00"};
+            history.push_back(transaction);
+        }
+        counting.store(false);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printHistoryLine("std::string rows", allocations.load() - before, seconds, liveBytes.load() - baseLive,
+                         transactions);
+        const size_t inline_ = std::string().capacity();
+        for (const StringTransaction& transaction : history) {
+            heapCopies += (transaction.customerName.size() > inline_) + (transaction.timestamp.size() > inline_);
+            for (const auto& line : transaction.items) {
+                heapCopies += (line.first.name.size() > inline_) + (line.first.aisle.size() > inline_);
+            }
+        }
+    }
+
+    AVLTree inventory;
+    buildInventory(inventory, kHistoryItems, 8);
+    std::error_code ec;
+    std::filesystem::remove(logFile, ec);
+    size_t baseLive = liveBytes.load();
+    size_t rowMemory = 0;
+    size_t columnMemory = 0;
+    size_t indexMemory = 0;
+    {
+        GroupCommitOptions durability;
+        durability.policy = DurabilityPolicy::Async;
+        TransactionManager manager(logFile, "", durability);
+        std::vector<InternedString> names;
+        for (const std::string& customer : customers) names.emplace_back(customer);
+        InternedString guest("Guest");
+        std::vector<std::pair<GroceryItem, int>> lines;
+        size_t before = allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        counting.store(true);
+        for (int t = 0; t < transactions; ++t) {
+            lines.clear();
+            for (int k = 0; k < kLinesPerCart; ++k) {
+                lines.emplace_back(*inventory.search(lineUpc(t, k)), 1 + k);
+            }
+            int customer = customerOf(t);
+            manager.addTransaction(customer, customer < 0 ? guest : names[customer], lines,
+                                   Money::fromCents(1000), Money(), Money::fromCents(80), Money::fromCents(1080));
+        }
+        manager.flush();
+        counting.store(false);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printHistoryLine("interned, recorded", allocations.load() - before, seconds, liveBytes.load() - baseLive,
+                         transactions);
+        rowMemory = manager.getRowMemoryUsage();
+        columnMemory = manager.getColumnMemoryUsage();
+        indexMemory = manager.getIndexMemoryUsage();
+    }
+    {
+        size_t before = allocations.load();
+        auto start = std::chrono::steady_clock::now();
+        counting.store(true);
+        TransactionManager manager(logFile, "");
+        counting.store(false);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        printHistoryLine("interned, reloaded", allocations.load() - before, seconds, liveBytes.load() - baseLive,
+                         transactions);
+    }
+    std::cout << "  heap text copies kept per transaction: " << double(heapCopies) / transactions
+              << " as std::string, 0 interned (" << StringInterner::global().size() << " distinct strings, "
+              << StringInterner::global().memoryUsage() / 1e6 << " MB pool)" << std::endl;
+    std::cout << "  memory per transaction: rows " << double(rowMemory) / transactions << " bytes, columns "
+              << double(columnMemory) / transactions << " bytes, ID and customer indexes "
+              << double(indexMemory) / transactions << " bytes (live figures above include all three)" << std::endl;
+    std::filesystem::remove(logFile, ec);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int checkouts = 200000;
+    int history = 0;
+    std::string logFile = "allocations.log";
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--checkouts") == 0 && i + 1 < argc) {
+            checkouts = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--history") == 0 && i + 1 < argc) {
+            history = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--log") == 0 && i + 1 < argc) {
+            logFile = argv[++i];
+        } else {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+    if (checkouts <= 0 || history < 0) {
+        std::cerr << "--checkouts must be positive" << std::endl;
+        return 2;
+    }
+
+    if (history > 0) {
+        countHistory(history, logFile);
+        return 0;
+    }
+    std::error_code ec;
+    std::filesystem::remove(logFile, ec);
+    bool ok = countCheckouts(checkouts, logFile);
+    std::filesystem::remove(logFile, ec);
+    return ok ? 0 : 1;
+}
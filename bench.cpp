@@ -0,0 +1,887 @@
+// bench.cpp - Micro-benchmarks for the store's data structures and logs
+// Part of CSC 307 Grocery Store Simulator project
+//
+//   bench [BENCHMARK...]   run the named benchmarks (all of them if none given)
+//   bench --list           list the benchmarks
+//
+// Timings are wall-clock; build with -O2 and run on an idle machine.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AVLTree.h"
+#include "AggregationKernels.h"
+#include "BPlusTree.h"
+#include "CatalogLoader.h"
+#include "CheckoutEngine.h"
+#include "InventoryImage.h"
+#include "InventoryLog.h"
+#include "TransactionJournal.h"
+#include "TransactionProcessing.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const char* const kAisles[] = {"Produce", "Dairy", "Bakery", "Meat", "Frozen", "Pantry", "Snacks", "Household"};
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// count items with distinct UPCs from 100000 up, in random order
+std::vector<GroceryItem> shuffledItems(size_t count, uint64_t seed) {
+    std::vector<GroceryItem> items;
+    items.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        items.emplace_back("Item " + std::to_string(i), UpcKey::fromRaw(100000 + i),
+                           Money::fromCents(99 + static_cast<int64_t>(i * 37 % 1900)), 150, kAisles[i % 8]);
+    }
+    std::shuffle(items.begin(), items.end(), std::mt19937_64(seed));
+    return items;
+}
+
+// One row of a two-way comparison: ns per operation each, and the ratio
+void printRate(const char* what, double firstSeconds, double secondSeconds, size_t operations) {
+    std::cout << "  " << std::left << std::setw(14) << what << std::right << std::setw(10)
+              << firstSeconds * 1e9 / operations << std::setw(10) << secondSeconds * 1e9 / operations
+              << std::setw(9) << firstSeconds / secondSeconds << "x" << std::endl;
+}
+
+// Time each phase of one index's life over the same items and lookups
+template <typename Index, typename Scan>
+void timeIndex(const std::vector<GroceryItem>& items, const std::vector<UpcKey>& lookups, Scan scan,
+               double seconds[4], uint64_t& check) {
+    Index index;
+    Clock::time_point start = Clock::now();
+    for (const GroceryItem& item : items) index.insert(item);
+    seconds[0] = secondsSince(start);
+
+    start = Clock::now();
+    for (UpcKey upc : lookups) check += index.search(upc)->getQuantity();
+    seconds[1] = secondsSince(start);
+
+    start = Clock::now();
+    for (int pass = 0; pass < 10; ++pass) check += scan(index);
+    seconds[2] = secondsSince(start) / 10;
+
+    start = Clock::now();
+    for (const GroceryItem& item : items) index.remove(item.getUpc());
+    seconds[3] = secondsSince(start);
+}
+
+// AVLTree against BPlusTree: random inserts, random hit lookups, a full
+// ordered scan and random removals, in ns per item or lookup
+void benchIndex() {
+    const size_t kLookups = 2000000;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t count : {10000, 100000, 1000000}) {
+        std::vector<GroceryItem> items = shuffledItems(count, count);
+        std::vector<UpcKey> lookups(kLookups);
+        std::mt19937_64 rng(7);
+        for (UpcKey& upc : lookups) upc = items[rng() % count].getUpc();
+
+        uint64_t check = 0;
+        double avl[4], bplus[4];
+        timeIndex<AVLTree>(items, lookups, [](const AVLTree& tree) {
+            int64_t units = 0;
+            tree.forEachItem([&units](const GroceryItem& item) { units += item.getQuantity(); });
+            return units;
+        }, avl, check);
+        timeIndex<BPlusTree>(items, lookups, [](const BPlusTree& tree) {
+            int64_t units = 0;
+            for (const GroceryItem& item : tree.allItems()) units += item.getQuantity();
+            return units;
+        }, bplus, check);
+
+        std::cout << "  " << std::left << std::setw(14) << (std::to_string(count) + " items") << std::right
+                  << std::setw(10) << "AVL ns" << std::setw(10) << "B+ ns" << std::setw(10) << "AVL/B+" << std::endl;
+        printRate("insert", avl[0], bplus[0], count);
+        printRate("search", avl[1], bplus[1], kLookups);
+        printRate("ordered scan", avl[2], bplus[2], count);
+        printRate("remove", avl[3], bplus[3], count);
+        std::cout << "  (check " << check % 1000 << ")" << std::endl;
+    }
+}
+
+// The inventory tree as it was before NodePool: the same AVL rotations,
+// but every node is its own new and delete, linked by pointer
+class HeapNodeTree {
+private:
+    struct Node {
+        GroceryItem item;
+        Node* left;
+        Node* right;
+        int height;
+
+        explicit Node(const GroceryItem& i) : item(i), left(nullptr), right(nullptr), height(1) {}
+    };
+
+    Node* root;
+
+    static int height(Node* node) { return node == nullptr ? 0 : node->height; }
+    static int balanceFactor(Node* node) { return node == nullptr ? 0 : height(node->left) - height(node->right); }
+    static void updateHeight(Node* node) { node->height = 1 + std::max(height(node->left), height(node->right)); }
+
+    static Node* rightRotate(Node* y) {
+        Node* x = y->left;
+        y->left = x->right;
+        x->right = y;
+        updateHeight(y);
+        updateHeight(x);
+        return x;
+    }
+
+    static Node* leftRotate(Node* x) {
+        Node* y = x->right;
+        x->right = y->left;
+        y->left = x;
+        updateHeight(x);
+        updateHeight(y);
+        return y;
+    }
+
+    static Node* insertNode(Node* node, const GroceryItem& item) {
+        if (node == nullptr) return new Node(item);
+        if (item.getUpc() < node->item.getUpc()) {
+            node->left = insertNode(node->left, item);
+        } else if (item.getUpc() > node->item.getUpc()) {
+            node->right = insertNode(node->right, item);
+        } else {
+            return node;
+        }
+        updateHeight(node);
+        int balance = balanceFactor(node);
+        if (balance > 1 && item.getUpc() < node->left->item.getUpc()) return rightRotate(node);
+        if (balance < -1 && item.getUpc() > node->right->item.getUpc()) return leftRotate(node);
+        if (balance > 1 && item.getUpc() > node->left->item.getUpc()) {
+            node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+        if (balance < -1 && item.getUpc() < node->right->item.getUpc()) {
+            node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    static Node* deleteNode(Node* node, UpcKey upc) {
+        if (node == nullptr) return node;
+        if (upc < node->item.getUpc()) {
+            node->left = deleteNode(node->left, upc);
+        } else if (upc > node->item.getUpc()) {
+            node->right = deleteNode(node->right, upc);
+        } else {
+            if (node->left == nullptr || node->right == nullptr) {
+                Node* child = node->left != nullptr ? node->left : node->right;
+                delete node;
+                return child;
+            }
+            Node* next = node->right;
+            while (next->left != nullptr) next = next->left;
+            node->item = next->item;
+            node->right = deleteNode(node->right, next->item.getUpc());
+        }
+        updateHeight(node);
+        int balance = balanceFactor(node);
+        if (balance > 1 && balanceFactor(node->left) >= 0) return rightRotate(node);
+        if (balance > 1) {
+            node->left = leftRotate(node->left);
+            return rightRotate(node);
+        }
+        if (balance < -1 && balanceFactor(node->right) <= 0) return leftRotate(node);
+        if (balance < -1) {
+            node->right = rightRotate(node->right);
+            return leftRotate(node);
+        }
+        return node;
+    }
+
+    static void clearTree(Node* node) {
+        if (node == nullptr) return;
+        clearTree(node->left);
+        clearTree(node->right);
+        delete node;
+    }
+
+public:
+    HeapNodeTree() : root(nullptr) {}
+    ~HeapNodeTree() { clearTree(root); }
+    HeapNodeTree(const HeapNodeTree&) = delete;
+    HeapNodeTree& operator=(const HeapNodeTree&) = delete;
+
+    void insert(const GroceryItem& item) { root = insertNode(root, item); }
+    void remove(UpcKey upc) { root = deleteNode(root, upc); }
+
+    const GroceryItem* search(UpcKey upc) const {
+        Node* node = root;
+        while (node != nullptr && node->item.getUpc() != upc) {
+            node = upc < node->item.getUpc() ? node->left : node->right;
+        }
+        return node == nullptr ? nullptr : &node->item;
+    }
+};
+
+// Insert every item, look up, remove half the items in random order,
+// then time tearing down what is left
+template <typename Tree>
+void timeNodes(const std::vector<GroceryItem>& items, const std::vector<UpcKey>& lookups, double seconds[4],
+               uint64_t& check) {
+    std::unique_ptr<Tree> tree(new Tree());
+    Clock::time_point start = Clock::now();
+    for (const GroceryItem& item : items) tree->insert(item);
+    seconds[0] = secondsSince(start);
+
+    start = Clock::now();
+    for (UpcKey upc : lookups) check += tree->search(upc)->getQuantity();
+    seconds[1] = secondsSince(start);
+
+    start = Clock::now();
+    for (size_t i = 0; i < items.size() / 2; ++i) tree->remove(items[i].getUpc());
+    seconds[2] = secondsSince(start);
+
+    start = Clock::now();
+    tree.reset();
+    seconds[3] = secondsSince(start);
+}
+
+// AVLTree's NodePool against a node-per-new tree with the same balancing:
+// random inserts, random hit lookups and random removals of half the
+// items in ns per operation, then teardown of the other half in ms
+void benchNodePool() {
+    const size_t kLookups = 2000000;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t count : {10000, 1000000, 10000000}) {
+        std::vector<GroceryItem> items = shuffledItems(count, count);
+        std::vector<UpcKey> lookups(kLookups);
+        std::mt19937_64 rng(11);
+        for (UpcKey& upc : lookups) upc = items[rng() % count].getUpc();
+
+        uint64_t check = 0;
+        double heap[4], pooled[4];
+        timeNodes<HeapNodeTree>(items, lookups, heap, check);
+        timeNodes<AVLTree>(items, lookups, pooled, check);
+
+        std::cout << "  " << std::left << std::setw(14) << (std::to_string(count) + " items") << std::right
+                  << std::setw(10) << "new ns" << std::setw(10) << "pool ns" << std::setw(10) << "new/pool"
+                  << std::endl;
+        printRate("insert", heap[0], pooled[0], count);
+        printRate("search", heap[1], pooled[1], kLookups);
+        printRate("remove", heap[2], pooled[2], count / 2);
+        std::cout << "  " << std::left << std::setw(14) << "teardown ms" << std::right << std::setw(10)
+                  << heap[3] * 1e3 << std::setw(10) << pooled[3] * 1e3 << std::setw(9) << heap[3] / pooled[3]
+                  << "x" << std::endl;
+        std::cout << "  (check " << check % 1000 << ")" << std::endl;
+    }
+}
+
+// items as a catalog CSV, in the order given
+void writeCatalogCsv(const std::string& path, const std::vector<GroceryItem>& items) {
+    std::ofstream file(path, std::ios::binary);
+    file << "upc,name,price,quantity,aisle\n";
+    char price[32];
+    for (const GroceryItem& item : items) {
+        int64_t cents = item.getPrice().getCents();
+        std::snprintf(price, sizeof price, "%lld.%02lld", (long long)(cents / 100), (long long)(cents % 100));
+        file << item.getUpc() << ',' << item.getName() << ',' << price << ',' << item.getQuantity() << ','
+             << item.getAisle() << '\n';
+    }
+}
+
+void printMs(const char* what, double seconds) {
+    std::cout << "  " << std::left << std::setw(36) << what << std::right << std::setw(10) << seconds * 1e3
+              << " ms" << std::endl;
+}
+
+// Catalog startup: repeated insert against loadCatalog from a sorted CSV,
+// a shuffled CSV and the binary format, then the aisle and name indexes:
+// building them, and queries against walking the whole tree
+void benchCatalogOver(size_t count) {
+    std::vector<GroceryItem> items = shuffledItems(count, count);
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gss-bench";
+    std::filesystem::create_directories(dir);
+    std::string shuffledPath = (dir / "shuffled.csv").string();
+    std::string sortedPath = (dir / "sorted.csv").string();
+    std::string binaryPath = (dir / "catalog.bin").string();
+    writeCatalogCsv(shuffledPath, items);
+    std::vector<GroceryItem> sorted = items;
+    std::sort(sorted.begin(), sorted.end(),
+              [](const GroceryItem& a, const GroceryItem& b) { return a.getUpc() < b.getUpc(); });
+    writeCatalogCsv(sortedPath, sorted);
+    sorted.clear();
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << count << " items, " << std::filesystem::file_size(shuffledPath) / 1000000 << " MB CSV"
+              << std::endl;
+
+    uint64_t check = 0;
+    {
+        AVLTree inventory;
+        Clock::time_point start = Clock::now();
+        for (const GroceryItem& item : items) inventory.insert(item);
+        printMs("repeated insert, shuffled", secondsSince(start));
+        saveCatalogBinary(binaryPath, inventory);
+    }
+    const std::pair<const char*, std::string> loads[] = {
+        {"loadCatalog, sorted CSV", sortedPath},
+        {"loadCatalog, shuffled CSV", shuffledPath},
+        {"loadCatalog, binary", binaryPath},
+    };
+    for (const auto& load : loads) {
+        AVLTree inventory;
+        Clock::time_point start = Clock::now();
+        CatalogLoadResult result = loadCatalog(load.second, inventory);
+        printMs(load.first, secondsSince(start));
+        check += result.loaded;
+    }
+
+    AVLTree inventory;
+    loadCatalog(binaryPath, inventory);
+    Clock::time_point start = Clock::now();
+    inventory.enableSecondaryIndexes();
+    printMs("building the aisle and name indexes", secondsSince(start));
+
+    // "Item 12345" matches itself and "Item 123450" to "Item 123459"
+    const size_t kQueries = 200000;
+    std::vector<std::string> prefixes(kQueries);
+    std::mt19937_64 rng(17);
+    for (std::string& prefix : prefixes) prefix = "Item " + std::to_string(10000 + rng() % 90000);
+    start = Clock::now();
+    size_t hits = 0;
+    for (const std::string& prefix : prefixes) {
+        for (UpcKey upc : inventory.itemsWithNamePrefix(prefix)) {
+            hits++;
+            check += upc.raw();
+        }
+    }
+    double seconds = secondsSince(start);
+    std::cout << "  " << std::left << std::setw(36) << "name prefix query" << std::right << std::setw(10)
+              << seconds * 1e6 / kQueries << " us, " << double(hits) / kQueries << " hits each" << std::endl;
+
+    start = Clock::now();
+    for (const char* aisle : kAisles) {
+        for (UpcKey upc : inventory.itemsInAisle(aisle)) check += upc.raw();
+    }
+    printMs("listing every aisle, index", secondsSince(start));
+    start = Clock::now();
+    for (const char* aisle : kAisles) {
+        inventory.forEachItem([&](const GroceryItem& item) {
+            if (item.getAisle() == aisle) check += item.getUpc().raw();
+        });
+    }
+    printMs("listing every aisle, tree walks", secondsSince(start));
+    std::cout << "  (check " << check % 1000 << ")" << std::endl;
+    std::filesystem::remove_all(dir);
+}
+
+void benchCatalog() {
+    benchCatalogOver(100000);
+    benchCatalogOver(1000000);
+}
+
+// Startup to the first successful lookup: building the tree by insert
+// calls, against mapping an inventory image (the checkpoint format) and
+// searching it in place, decoding the whole tree from it, and
+// FastStartInventory answering from the image while the tree builds. The
+// image has just been written, so the page cache is warm.
+void benchImageOver(size_t count) {
+    std::vector<GroceryItem> items = shuffledItems(count, count);
+    UpcKey wanted = items[count / 2].getUpc();
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gss-bench";
+    std::filesystem::create_directories(dir);
+    std::string imagePath = (dir / "inventory.ckpt").string();
+    std::string logPath = (dir / "inventory.log").string();
+    std::filesystem::remove(logPath);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << count / 1000000 << "M items" << std::endl;
+
+    uint64_t check = 0;
+    {
+        AVLTree inventory;
+        Clock::time_point start = Clock::now();
+        for (const GroceryItem& item : items) inventory.insert(item);
+        check += inventory.search(wanted)->getQuantity();
+        printMs("insert() calls + lookup", secondsSince(start));
+        items.clear();
+        items.shrink_to_fit();
+
+        start = Clock::now();
+        writeInventoryImage(imagePath, inventory);
+        printMs("writing the image", secondsSince(start));
+        std::cout << "  " << std::left << std::setw(36) << "image size" << std::right << std::setw(10)
+                  << std::filesystem::file_size(imagePath) / 1e6 << " MB" << std::endl;
+    }
+    GroceryItem found;
+    {
+        InventoryImage image;
+        Clock::time_point start = Clock::now();
+        image.open(imagePath);
+        check += image.find(wanted, found) ? found.getQuantity() : 0;
+        printMs("map image + lookup", secondsSince(start));
+
+        start = Clock::now();
+        check += image.verify();
+        printMs("body CRC verify", secondsSince(start));
+
+        AVLTree inventory;
+        start = Clock::now();
+        image.buildTree(inventory);
+        check += inventory.search(wanted)->getQuantity();
+        printMs("full tree from image + lookup", secondsSince(start));
+    }
+    {
+        AVLTree inventory;
+        InventoryLog log(logPath, imagePath);
+        FastStartInventory fastStart(log, inventory);
+        Clock::time_point start = Clock::now();
+        fastStart.start();
+        check += fastStart.lookup(wanted, found) ? found.getQuantity() : 0;
+        printMs("FastStart: first lookup", secondsSince(start));
+        fastStart.wait();
+        printMs("FastStart: tree ready", secondsSince(start));
+        check += inventory.size();
+    }
+    std::cout << "  (check " << check % 1000 << ")" << std::endl;
+    std::filesystem::remove_all(dir);
+}
+
+void benchImage() {
+    benchImageOver(1000000);
+    benchImageOver(10000000);
+}
+
+// count four-line transactions over a small catalog, as a checkout would log them
+std::vector<Transaction> sampleTransactions(size_t count) {
+    std::vector<GroceryItem> catalog = shuffledItems(2000, 3);
+    std::vector<Transaction> transactions;
+    transactions.reserve(count);
+    for (size_t t = 0; t < count; ++t) {
+        std::vector<std::pair<GroceryItem, int>> lines;
+        for (size_t k = 0; k < 4; ++k) {
+            lines.emplace_back(catalog[(t * 7 + k * 131) % catalog.size()], static_cast<int>(1 + k));
+        }
+        transactions.emplace_back(static_cast<int>(t + 1), t % 10 == 0 ? -1 : static_cast<int>(t % 2000),
+                                  InternedString(t % 10 == 0 ? "Guest" : "Loyalty Customer " + std::to_string(t % 2000)),
+                                  std::move(lines), Money::fromCents(1000), Money(), Money::fromCents(80),
+                                  Money::fromCents(1080));
+    }
+    return transactions;
+}
+
+void printThroughput(const char* what, double seconds, size_t records, uintmax_t bytes) {
+    std::cout << "  " << std::left << std::setw(30) << what << std::right << std::setw(12)
+              << records / seconds << " records/s" << std::setw(9) << bytes / seconds / 1e6 << " MB/s"
+              << std::setw(7) << double(bytes) / records << " bytes/record" << std::endl;
+}
+
+// The binary journal against the CSV log it replaced: encoding included,
+// no syncs unless stated, file sizes as written
+void benchJournal() {
+    const size_t kRecords = 200000;
+    std::vector<Transaction> transactions = sampleTransactions(kRecords);
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gss-bench";
+    std::filesystem::create_directories(dir);
+    std::string csvPath = (dir / "transactions.csv").string();
+    std::string journalPath = (dir / "transactions.log").string();
+    std::cout << std::fixed << std::setprecision(1);
+
+    // What saveToFile did for every checkout: open, append one line, close
+    std::filesystem::remove(csvPath);
+    Clock::time_point start = Clock::now();
+    for (const Transaction& transaction : transactions) {
+        std::ofstream file(csvPath, std::ios::app);
+        file << transaction.toCSV() << std::endl;
+    }
+    printThroughput("CSV, reopened per record", secondsSince(start), kRecords, std::filesystem::file_size(csvPath));
+
+    std::filesystem::remove(csvPath);
+    start = Clock::now();
+    {
+        std::ofstream file(csvPath, std::ios::app);
+        for (const Transaction& transaction : transactions) file << transaction.toCSV() << '\n';
+    }
+    printThroughput("CSV, kept open", secondsSince(start), kRecords, std::filesystem::file_size(csvPath));
+
+    for (size_t syncEvery : {size_t(0), size_t(256)}) {
+        std::filesystem::remove(journalPath);
+        start = Clock::now();
+        {
+            JournalWriter journal;
+            journal.open(journalPath, 0);
+            std::vector<unsigned char> record;
+            for (size_t i = 0; i < transactions.size(); ++i) {
+                record.clear();
+                transactions[i].appendBinary(record);
+                journal.append(record);
+                if (syncEvery != 0 && (i + 1) % syncEvery == 0) journal.sync();
+            }
+            journal.flush();
+        }
+        printThroughput(syncEvery == 0 ? "journal" : "journal, synced every 256", secondsSince(start), kRecords,
+                        std::filesystem::file_size(journalPath));
+    }
+    std::filesystem::remove_all(dir);
+}
+
+// The CSV import as it was before MappedFile: getline per line, a vector
+// of std::string per line and per item, std::stoi and std::stod
+size_t legacyLoadCsv(const std::string& path, std::vector<Transaction>& out) {
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        std::istringstream iss(line);
+        std::string token;
+        std::vector<std::string> tokens;
+        while (std::getline(iss, token, ',')) tokens.push_back(token);
+        if (tokens.size() < 9) continue;
+
+        // The item list itself contains commas, so rejoin the remaining tokens
+        std::string itemsField = tokens[8];
+        for (size_t t = 9; t < tokens.size(); ++t) itemsField += "," + tokens[t];
+        std::vector<std::pair<GroceryItem, int>> items;
+        std::istringstream itemsStream(itemsField);
+        std::string itemData;
+        while (std::getline(itemsStream, itemData, ';')) {
+            std::istringstream itemStream(itemData);
+            std::string itemToken;
+            std::vector<std::string> itemTokens;
+            while (std::getline(itemStream, itemToken, ',')) itemTokens.push_back(itemToken);
+            UpcKey upc;
+            if (itemTokens.size() >= 3 && UpcKey::parse(itemTokens[0], upc)) {
+                GroceryItem item("Item #" + itemTokens[0], upc, Money::fromDouble(std::stod(itemTokens[2])), 0, "");
+                items.push_back(std::make_pair(item, std::stoi(itemTokens[1])));
+            }
+        }
+        out.emplace_back(std::stoi(tokens[0]), std::stoi(tokens[1]), InternedString(tokens[2]), std::move(items),
+                         Money::fromDouble(std::stod(tokens[3])), Money::fromDouble(std::stod(tokens[4])),
+                         Money::fromDouble(std::stod(tokens[5])), Money::fromDouble(std::stod(tokens[6])), tokens[7]);
+    }
+    return out.size();
+}
+
+// A legacy CSV log of count two-line transactions spread over 2024
+void writeLegacyCsv(const std::string& path, size_t count) {
+    std::ofstream file(path, std::ios::binary);
+    std::string text;
+    char line[256];
+    for (size_t t = 0; t < count; ++t) {
+        int64_t cents[2] = {99 + static_cast<int64_t>(t * 37 % 1900), 99 + static_cast<int64_t>(t * 53 % 1900)};
+        int quantity[2] = {1 + static_cast<int>(t % 3), 1 + static_cast<int>(t % 5)};
+        int64_t subtotal = cents[0] * quantity[0] + cents[1] * quantity[1];
+        int64_t tax = (subtotal * 825 + 5000) / 10000;
+        int64_t second = static_cast<int64_t>(t * (366.0 * 86400 / count));
+        int day = static_cast<int>(second / 86400);
+        int month = 1, monthDays[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+        while (day >= monthDays[month - 1]) day -= monthDays[month++ - 1];
+        int customer = static_cast<int>(t % 2000);
+        std::snprintf(line, sizeof line,
+                      "%zu,%d,Customer %d,%lld.%02lld,0.00,%lld.%02lld,%lld.%02lld,2024-%02d-%02d %02lld:%02lld:%02lld,"
+                      "%zu,%d,%lld.%02lld;%zu,%d,%lld.%02lld\n",
+                      t + 1, customer, customer, (long long)(subtotal / 100), (long long)(subtotal % 100),
+                      (long long)(tax / 100), (long long)(tax % 100), (long long)((subtotal + tax) / 100),
+                      (long long)((subtotal + tax) % 100), month, day + 1, (long long)(second / 3600 % 24),
+                      (long long)(second / 60 % 60), (long long)(second % 60), size_t(100000 + t % 5000), quantity[0],
+                      (long long)(cents[0] / 100), (long long)(cents[0] % 100), size_t(100000 + (t * 7 + 1) % 5000),
+                      quantity[1], (long long)(cents[1] / 100), (long long)(cents[1] % 100));
+        text += line;
+        if (text.size() > (1 << 20)) {
+            file.write(text.data(), static_cast<std::streamsize>(text.size()));
+            text.clear();
+        }
+    }
+    file.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+void printStartup(const char* what, double seconds, size_t transactions) {
+    std::cout << "  " << std::left << std::setw(40) << what << std::right << std::setw(8) << seconds
+              << " s" << std::setw(12) << transactions / seconds << " transactions/s" << std::endl;
+}
+
+// Startup over a synthetic history of count transactions: the old getline
+// parse of the CSV, the first start (mapped CSV import that also writes
+// the journal and builds the indexes and aggregates), and every later
+// start (mapped journal, decoded in parallel)
+void benchLoaderOver(size_t count) {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "gss-bench";
+    std::filesystem::create_directories(dir);
+    std::string csvPath = (dir / "history.csv").string();
+    std::string journalPath = (dir / "history.log").string();
+    std::filesystem::remove(journalPath);
+    writeLegacyCsv(csvPath, count);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << count / 1000000 << "M transactions, " << std::filesystem::file_size(csvPath) / 1000000
+              << " MB CSV, " << std::max(1u, std::thread::hardware_concurrency()) << " loader threads at most"
+              << std::endl;
+
+    {
+        std::vector<Transaction> transactions;
+        Clock::time_point start = Clock::now();
+        size_t loaded = legacyLoadCsv(csvPath, transactions);
+        printStartup("CSV, getline (old loader, rows only)", secondsSince(start), loaded);
+    }
+    {
+        Clock::time_point start = Clock::now();
+        TransactionManager manager(journalPath, csvPath);
+        printStartup("CSV, mapped (first start, writes journal)", secondsSince(start), manager.getTransactionCount());
+    }
+    std::cout << "  " << std::setw(40) << std::left << "journal size" << std::right << std::setw(8)
+              << std::filesystem::file_size(journalPath) / 1e6 << " MB" << std::endl;
+    {
+        Clock::time_point start = Clock::now();
+        TransactionManager manager(journalPath, "");
+        printStartup("journal, mapped (every later start)", secondsSince(start), manager.getTransactionCount());
+    }
+    std::filesystem::remove_all(dir);
+}
+
+// 10M transactions peak near 5 GB of resident memory, mapped files included
+void benchLoader() {
+    benchLoaderOver(1000000);
+    benchLoaderOver(10000000);
+}
+
+// Time kernel over passes runs; returns seconds per pass
+template <typename Kernel>
+double timeKernel(Kernel kernel, int passes, int64_t& result) {
+    Clock::time_point start = Clock::now();
+    for (int pass = 0; pass < passes; ++pass) result = kernel();
+    return secondsSince(start) / passes;
+}
+
+// The sales report's column reductions, scalar against AVX2, over rows
+// of totals and timestamps
+void benchKernelsOver(size_t rows) {
+    std::vector<int64_t> totals(rows);
+    std::vector<int64_t> times(rows);
+    std::mt19937_64 rng(13);
+    const int64_t kYearStart = 1704067200; // 2024-01-01
+    for (size_t i = 0; i < rows; ++i) {
+        totals[i] = 1 + static_cast<int64_t>(rng() % 20000);
+        times[i] = kYearStart + static_cast<int64_t>(i * (366 * 86400 / static_cast<double>(rows)));
+    }
+    const int64_t from = kYearStart + 152 * 86400; // June
+    const int64_t to = from + 30 * 86400;
+    const int passes = static_cast<int>(std::max<size_t>(5, 500000000 / rows));
+
+    struct Kernel {
+        const char* name;
+        int64_t (*run)(const std::vector<int64_t>&, const std::vector<int64_t>&, int64_t, int64_t);
+    };
+    const Kernel kernels[] = {
+        {"sum", [](const std::vector<int64_t>& v, const std::vector<int64_t>&, int64_t, int64_t) {
+             return sumColumn(v.data(), v.size());
+         }},
+        {"sum in time range", [](const std::vector<int64_t>& v, const std::vector<int64_t>& t, int64_t a, int64_t b) {
+             return sumInTimeRange(v.data(), t.data(), v.size(), a, b);
+         }},
+        {"min/max", [](const std::vector<int64_t>& v, const std::vector<int64_t>&, int64_t, int64_t) {
+             int64_t low = 0, high = 0;
+             minMaxColumn(v.data(), v.size(), low, high);
+             return low * 100000 + high;
+         }},
+    };
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << rows / 1000000 << "M rows, best kernel on this CPU: " << aggregationKernelName() << std::endl;
+    std::cout << "  " << std::left << std::setw(20) << "" << std::right << std::setw(11) << "scalar ms"
+              << std::setw(11) << "simd ms" << std::setw(11) << "Mrows/s" << std::setw(10) << "speedup" << std::endl;
+    for (const Kernel& kernel : kernels) {
+        int64_t scalarResult = 0, simdResult = 0;
+        useScalarKernels(true);
+        double scalar = timeKernel([&] { return kernel.run(totals, times, from, to); }, passes, scalarResult);
+        useScalarKernels(false);
+        double simd = timeKernel([&] { return kernel.run(totals, times, from, to); }, passes, simdResult);
+        std::cout << "  " << std::left << std::setw(20) << kernel.name << std::right << std::setw(11)
+                  << scalar * 1e3 << std::setw(11) << simd * 1e3 << std::setw(11)
+                  << rows / simd / 1e6 << std::setw(9) << scalar / simd << "x"
+                  << (scalarResult == simdResult ? "" : "  RESULTS DIFFER") << std::endl;
+    }
+}
+
+// 1M rows stay in cache; 100M rows (1.6 GB) are bound by memory bandwidth
+void benchKernels() {
+    benchKernelsOver(1000000);
+    benchKernelsOver(100000000);
+}
+
+// count items with stock that no benchmark run can sell out
+void stockInventory(AVLTree& inventory, size_t count) {
+    for (GroceryItem& item : shuffledItems(count, count)) {
+        item.setQuantity(1 << 30);
+        inventory.insert(item);
+    }
+}
+
+// count carts of linesPerCart scans over catalogSize items; about one scan
+// in five repeats a UPC already scanned into the same cart
+std::vector<std::pair<UpcKey, int>> sampleScans(size_t count, size_t linesPerCart, size_t catalogSize,
+                                                uint64_t seed) {
+    std::vector<std::pair<UpcKey, int>> scans(count * linesPerCart);
+    std::mt19937_64 rng(seed);
+    for (size_t i = 0; i < scans.size(); ++i) {
+        size_t line = i % linesPerCart;
+        if (line > 0 && rng() % 5 == 0) {
+            scans[i] = {scans[i - 1 - rng() % line].first, 1};
+        } else {
+            scans[i] = {UpcKey::fromRaw(100000 + rng() % catalogSize), static_cast<int>(1 + rng() % 3)};
+        }
+    }
+    return scans;
+}
+
+// Add every cart's scans, scan by scan or as one addItems batch, emptying
+// the cart after each
+double timeAdds(AVLTree& inventory, ShoppingCart& cart, const std::vector<std::pair<UpcKey, int>>& scans,
+                size_t linesPerCart, bool batch, int64_t& check) {
+    Clock::time_point start = Clock::now();
+    for (size_t first = 0; first < scans.size(); first += linesPerCart) {
+        if (batch) {
+            check += cart.addItems(inventory, scans.data() + first, linesPerCart).accepted;
+        } else {
+            for (size_t i = first; i < first + linesPerCart; ++i) {
+                check += cart.tryAddItem(inventory, scans[i].first, scans[i].second) == StockStatus::Ok;
+            }
+        }
+        cart.clearCart();
+    }
+    return secondsSince(start);
+}
+
+// One lane: add every cart's scans and check it out, with its own
+// inventory, cart and engine (no sinks). Returns seconds for the checkouts.
+double runLane(const std::vector<std::pair<UpcKey, int>>& scans, size_t linesPerCart, size_t catalogSize,
+               bool batch, int64_t& check) {
+    AVLTree inventory;
+    stockInventory(inventory, catalogSize);
+    ShoppingCart cart;
+    CheckoutEngine engine;
+    Clock::time_point start = Clock::now();
+    for (size_t first = 0; first < scans.size(); first += linesPerCart) {
+        if (batch) {
+            cart.addItems(inventory, scans.data() + first, linesPerCart);
+        } else {
+            for (size_t i = first; i < first + linesPerCart; ++i) {
+                cart.tryAddItem(inventory, scans[i].first, scans[i].second);
+            }
+        }
+        check += engine.checkout(cart).total.getCents();
+    }
+    return secondsSince(start);
+}
+
+// Cart adds scan by scan against addItems, then whole checkouts per
+// second: one lane, and one lane per core running at once
+void benchCheckout() {
+    const size_t kScans = 400000;
+    const size_t kCatalog = 100000;
+    const size_t kCarts = 200000;
+    std::cout << std::fixed << std::setprecision(1);
+
+    // 100K items stay in cache; 10M items do not, and there one sorted walk
+    // shares the top of the tree between a batch's scans
+    int64_t check = 0;
+    for (size_t catalog : {kCatalog, size_t(10000000)}) {
+        AVLTree inventory;
+        stockInventory(inventory, catalog);
+        ShoppingCart cart;
+        std::cout << "  " << std::left << std::setw(14) << (std::to_string(catalog) + " items") << std::right
+                  << std::setw(10) << "scan ns" << std::setw(10) << "batch ns" << std::setw(10) << "speedup"
+                  << std::endl;
+        for (size_t linesPerCart : {4, 16, 64, 1024}) {
+            std::vector<std::pair<UpcKey, int>> scans =
+                sampleScans(kScans / linesPerCart, linesPerCart, catalog, linesPerCart);
+            // Best of three rounds, the two ways taking turns
+            double seconds[2] = {1e9, 1e9};
+            for (int round = 0; round < 3; ++round) {
+                for (int batch = 0; batch < 2; ++batch) {
+                    seconds[batch] = std::min(seconds[batch], timeAdds(inventory, cart, scans, linesPerCart, batch, check));
+                }
+            }
+            printRate((std::to_string(linesPerCart) + " lines").c_str(), seconds[0], seconds[1], scans.size());
+        }
+    }
+
+    const size_t kLines = 16;
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "  " << kLines << "-scan carts, " << cores << (cores == 1 ? " core" : " cores") << std::endl;
+    for (int batch = 0; batch < 2; ++batch) {
+        std::vector<std::vector<std::pair<UpcKey, int>>> scans;
+        for (unsigned lane = 0; lane < cores; ++lane) {
+            scans.push_back(sampleScans(kCarts, kLines, kCatalog, 100 + lane));
+        }
+        double single = runLane(scans[0], kLines, kCatalog, batch, check);
+
+        std::vector<double> seconds(cores);
+        std::vector<int64_t> checks(cores);
+        std::vector<std::thread> lanes;
+        for (unsigned lane = 0; lane < cores; ++lane) {
+            lanes.emplace_back([&, lane] { seconds[lane] = runLane(scans[lane], kLines, kCatalog, batch, checks[lane]); });
+        }
+        for (std::thread& lane : lanes) lane.join();
+        double slowest = *std::max_element(seconds.begin(), seconds.end());
+        for (int64_t laneCheck : checks) check += laneCheck;
+        double together = kCarts * cores / slowest;
+
+        std::cout << "  " << std::left << std::setw(12) << (batch ? "batch adds" : "scan adds") << std::right
+                  << std::setw(11) << kCarts / single << " checkouts/s on one lane," << std::setw(11) << together
+                  << " on " << cores << " = " << together / cores << " per core" << std::endl;
+    }
+    std::cout << "  (check " << check % 1000 << ")" << std::endl;
+}
+
+struct Benchmark {
+    const char* name;
+    void (*run)();
+};
+
+const Benchmark kBenchmarks[] = {
+    {"index", benchIndex},
+    {"nodepool", benchNodePool},
+    {"catalog", benchCatalog},
+    {"image", benchImage},
+    {"journal", benchJournal},
+    {"loader", benchLoader},
+    {"kernels", benchKernels},
+    {"checkout", benchCheckout},
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const Benchmark*> selected;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--list") == 0) {
+            for (const Benchmark& benchmark : kBenchmarks) std::cout << benchmark.name << std::endl;
+            return 0;
+        }
+        const Benchmark* found = nullptr;
+        for (const Benchmark& benchmark : kBenchmarks) {
+            if (std::strcmp(argv[i], benchmark.name) == 0) found = &benchmark;
+        }
+        if (found == nullptr) {
+            std::cerr << "Unknown benchmark " << argv[i] << std::endl;
+            return 2;
+        }
+        selected.push_back(found);
+    }
+    if (selected.empty()) {
+        for (const Benchmark& benchmark : kBenchmarks) selected.push_back(&benchmark);
+    }
+
+    for (const Benchmark* benchmark : selected) {
+        std::cout << "== " << benchmark->name << " ==" << std::endl;
+        benchmark->run();
+    }
+    return 0;
+}
@@ -3,6 +3,10 @@
 #include "AVLTree.h"
 #include "ShoppingCart.h"
 #include "TransactionProcessing.h" 
+#include "CheckoutEngine.h"
+#include "CheckoutSimulation.h"
+#include "CatalogLoader.h"
+#include "InventoryLog.h"
 
 //Namespace directives to clean up code
 using std::cout;
@@ -10,6 +14,8 @@ using std::cin;
 using std::string;
 using std::endl;
 
+const int64_t kSalesTaxBasisPoints = CheckoutEngine::kDefaultTaxBasisPoints; // 8.25%
+
 void displayMenu() {
     std::cout << "\n===== GROCERY STORE INVENTORY SYSTEM =====" << endl;
     cout << "1. Add New Item" << endl;
@@ -19,13 +25,15 @@ void displayMenu() {
     cout << "5. Display All Items" << endl;
     cout << "6. Shopping Cart" << endl;
     cout << "7. Transaction Reports" << endl;
+    cout << "8. Run Checkout Simulation" << endl;
+    cout << "9. Browse by Aisle or Name" << endl;
     cout << "0. Exit" << endl;
     cout << "Enter your choice: ";
 }
 
 void addItem(AVLTree& inventory) {
-    string name, upcCode, aisle;
-    double price;
+    string name, upcCode, aisle, priceText;
+    Money price;
     int quantity;
     
     std::cout << "\n--- Add New Item ---" << endl;
@@ -33,8 +41,17 @@ void addItem(AVLTree& inventory) {
     cout << "Enter UPC Code: ";
     cin >> upcCode;
     
+    UpcKey upc;
+    if (!UpcKey::parse(upcCode, upc)) {
+        cout << "Error: UPC must be 1-" << UpcKey::kMaxDigits << " digits." << endl;
+        return;
+    }
+    if (upc.hasCheckDigit() && !upc.hasValidCheckDigit()) {
+        cout << "Warning: UPC " << upcCode << " has an invalid check digit." << endl;
+    }
+    
     // Check if UPC already exists
-    if (inventory.search(upcCode) != nullptr) {
+    if (inventory.search(upc) != nullptr) {
         cout << "Error: Item with UPC " << upcCode << " already exists." << endl;
         return;
     }
@@ -45,7 +62,11 @@ void addItem(AVLTree& inventory) {
    std::getline(std::cin, name);
     
     cout << "Enter Price: $";
-    cin >> price;
+    cin >> priceText;
+    if (!Money::parse(priceText, price)) {
+        cout << "Error: Price must be a dollar amount such as 3.99." << endl;
+        return;
+    }
     
     cout << "Enter Quantity: ";
     cin >> quantity;
@@ -55,28 +76,29 @@ void addItem(AVLTree& inventory) {
     cout << "Enter Aisle: ";
     std::getline(std::cin, aisle);
     
-    GroceryItem newItem(name, upcCode, price, quantity, aisle);
+    GroceryItem newItem(name, upc, price, quantity, aisle);
     inventory.insert(newItem);
     
     cout << "Item added successfully!" << std::endl;
 }
 
-void findItem(AVLTree& inventory) {
+// Answered from the checkpoint image while the inventory is still loading
+void findItem(const FastStartInventory& inventory) {
     string upcCode;
     
     cout << "\n--- Find Item ---" << std::endl;
     cout << "Enter UPC Code: ";
     cin >> upcCode;
     
-    GroceryItem* item = inventory.search(upcCode);
-    
-    if (item != nullptr) {
+    UpcKey upc;
+    GroceryItem item;
+    if (UpcKey::parse(upcCode, upc) && inventory.lookup(upc, item)) {
         cout << "\nItem Found:" << endl;
-        cout << "UPC Code: " << item->getUpcCode() << endl;
-        cout << "Name: " << item->getName() << endl;
-        cout << "Price: $" << item->getPrice() << endl;
-        cout << "Quantity: " << item->getQuantity() << endl;
-        cout << "Aisle: " << item->getAisle() << endl;
+        cout << "UPC Code: " << item.getUpc() << endl;
+        cout << "Name: " << item.getName() << endl;
+        cout << "Price: $" << item.getPrice() << endl;
+        cout << "Quantity: " << item.getQuantity() << endl;
+        cout << "Aisle: " << item.getAisle() << endl;
     } else {
         cout << "Item with UPC " << upcCode << " not found." << endl;
     }
@@ -92,13 +114,13 @@ void updateItem(AVLTree& inventory) {
     GroceryItem* item = inventory.search(upcCode);
     
     if (item != nullptr) {
-        string name = item->getName();
-        double price = item->getPrice();
+        string name(item->getName());
+        Money price = item->getPrice();
         int quantity = item->getQuantity();
-        string aisle = item->getAisle();
+        string aisle(item->getAisle());
         
         cout << "\nCurrent Item Details:" << endl;
-        cout << "UPC Code: " << item->getUpcCode() << endl;
+        cout << "UPC Code: " << item->getUpc() << endl;
         cout << "Name: " << name << endl;
         cout << "Price: $" << price << endl;
         cout << "Quantity: " << quantity << endl;
@@ -118,8 +140,12 @@ void updateItem(AVLTree& inventory) {
         cout << "Update price (y/n)? ";
         cin >> choice;
         if (choice == 'y' || choice == 'Y') {
+            string priceText;
             cout << "Enter new price: $";
-            cin >> price;
+            cin >> priceText;
+            if (!Money::parse(priceText, price)) {
+                cout << "Invalid price; keeping $" << item->getPrice() << "." << endl;
+            }
         }
         
         cout << "Update quantity (y/n)? ";
@@ -170,35 +196,111 @@ void processCheckout(AVLTree& inventory, ShoppingCart& cart, TransactionManager&
 
     // Display cart contents
     cout << "\n--- Checkout ---" << endl;
-    cart.displayCart();
+    cart.displayCart(inventory);
     
-    // Calculate totals
-    double subtotal = cart.getTotal();
-    double tax = subtotal * 0.0825; // 8.25% tax rate
-    double total = subtotal + tax;
-    
-    // Display receipt
-    cout << "\n--- Receipt ---" << endl;
-    cout << "Subtotal: $" << std::fixed << std::setprecision(2) << subtotal << endl;
-    cout << "Tax (8.25%): $" << std::fixed << std::setprecision(2) << tax << endl;
-    cout << "Total: $" << std::fixed << std::setprecision(2) << total << endl;
+    // Price the cart; the printer shows the receipt and the log sink
+    // records the transaction
+    CheckoutEngine engine(kSalesTaxBasisPoints);
+    ConsoleReceiptPrinter printer(inventory);
+    TransactionLogSink log(transactionManager, inventory);
+    engine.addSink(&printer);
+    engine.addSink(&log);
+    engine.checkout(cart);
 
-    // Record the transaction
-    int transactionId = transactionManager.addTransaction(
-        -1, // Guest customer ID
-        "Guest", // Customer name
-        cart.getItems(),
-        subtotal,
-        0.0, // Discount amount
-        tax,
-        total
-    );
+    cout << "Transaction #" << log.getLastTransactionId() << " has been recorded." << endl;
+    cout << "Thank you for your purchase!" << endl;
+}
 
-    cout << "Transaction #" << transactionId << " has been recorded." << endl;
+void browseItems(const AVLTree& inventory) {
+    char mode;
+    string text;
     
-    // Clear the cart
-    cart.clearCart();
-    cout << "Thank you for your purchase!" << endl;
+    cout << "\n--- Browse Items ---" << endl;
+    cout << "Search by (a)isle or (n)ame prefix? ";
+    cin >> mode;
+    cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    cout << (mode == 'a' || mode == 'A' ? "Enter aisle: " : "Enter start of name: ");
+    std::getline(std::cin, text);
+    
+    size_t found = 0;
+    auto show = [&](UpcKey upc) {
+        const GroceryItem* item = inventory.search(upc);
+        if (item == nullptr) return;
+        cout << "UPC: " << item->getUpc() << ", Name: " << item->getName()
+             << ", Price: $" << item->getPrice() << ", Quantity: " << item->getQuantity()
+             << ", Aisle: " << item->getAisle() << endl;
+        found++;
+    };
+    if (mode == 'a' || mode == 'A') {
+        for (UpcKey upc : inventory.itemsInAisle(text)) show(upc);
+    } else {
+        for (UpcKey upc : inventory.itemsWithNamePrefix(text)) show(upc);
+    }
+    if (found == 0) {
+        cout << "No matching items." << endl;
+    }
+}
+
+void runSimulation(const AVLTree& inventory) {
+    SimulationConfig config;
+    
+    cout << "\n--- Checkout Simulation ---" << endl;
+    cout << "Number of customers: ";
+    cin >> config.customers;
+    cout << "Number of lanes: ";
+    cin >> config.lanes;
+    cout << "Arrivals per second (0 = all at once): ";
+    cin >> config.arrivalsPerSecond;
+    cout << "Average items per basket: ";
+    cin >> config.meanBasketSize;
+    int store = 1;
+    cout << "Stock store (1 = per-SKU counters, 2 = versioned with live audits): ";
+    cin >> store;
+    config.stock = store == 2 ? StockStore::Versioned : StockStore::Ledger;
+    if (!cin || config.lanes == 0 || config.meanBasketSize == 0 || (store != 1 && store != 2)) {
+        cin.clear();
+        cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+        cout << "Invalid simulation settings." << endl;
+        return;
+    }
+    
+    // Runs against a copy of the inventory and logs to its own journal
+    printSimulationReport(runCheckoutSimulation(inventory, config));
+}
+
+// Report the inventory restored from the last run. On the first run, load
+// the store catalog if there is one, otherwise a few sample items, and
+// checkpoint it as the starting point.
+void finishStartup(FastStartInventory& fastStart, InventoryLog& inventoryLog, AVLTree& inventory) {
+    const InventoryRecoveryResult& recovered = fastStart.wait();
+    if (recovered.restored) {
+        cout << "Restored " << inventory.size() << " inventory items";
+        if (recovered.replayed > 0) {
+            cout << " (" << recovered.replayed << " logged change(s) replayed)";
+        }
+        cout << "." << endl;
+    } else {
+        CatalogLoadResult catalog = loadCatalog("catalog.bin", inventory);
+        if (!catalog.opened) {
+            catalog = loadCatalog("catalog.csv", inventory);
+        }
+        if (catalog.opened) {
+            cout << "Loaded " << catalog.loaded << " catalog items";
+            if (catalog.malformed + catalog.duplicates > 0) {
+                cout << " (skipped " << catalog.malformed << " bad and " << catalog.duplicates << " duplicate rows)";
+            }
+            cout << "." << endl;
+        } else {
+            inventory.insert(GroceryItem("Milk", "100001", Money::fromCents(399), 50, "Dairy"));
+            inventory.insert(GroceryItem("Bread", "100002", Money::fromCents(249), 30, "Bakery"));
+            inventory.insert(GroceryItem("Eggs", "100003", Money::fromCents(429), 40, "Dairy"));
+            inventory.insert(GroceryItem("Apples", "100004", Money::fromCents(199), 100, "Produce"));
+            inventory.insert(GroceryItem("Chicken", "100005", Money::fromCents(899), 20, "Meat"));
+        }
+        if (recovered.opened) {
+            inventoryLog.checkpoint();
+        }
+    }
 }
 
 int main() {
@@ -209,21 +311,31 @@ int main() {
     ShoppingCart cart;
     TransactionManager transactionManager;
 
-    inventory.insert(GroceryItem("Milk", "100001", 3.99, 50, "Dairy"));
-    inventory.insert(GroceryItem("Bread", "100002", 2.49, 30, "Bakery"));
-    inventory.insert(GroceryItem("Eggs", "100003", 4.29, 40, "Dairy"));
-    inventory.insert(GroceryItem("Apples", "100004", 1.99, 100, "Produce"));
-    inventory.insert(GroceryItem("Chicken", "100005", 8.99, 20, "Meat"));
+    // Restore the inventory saved by the last run in the background. After
+    // a clean shutdown, Find Item is answered from the checkpoint while it
+    // loads; any other choice waits for it first.
+    inventory.enableSecondaryIndexes();
+    InventoryLog inventoryLog;
+    FastStartInventory fastStart(inventoryLog, inventory);
+    bool earlyLookups = fastStart.start();
+    bool started = false;
     
     do {
+        if (started) {
+            inventoryLog.checkpointIfDue();
+        }
         displayMenu();
         cin >> choice;
+        if (!started && !(choice == 2 && earlyLookups && !fastStart.isReady())) {
+            finishStartup(fastStart, inventoryLog, inventory);
+            started = true;
+        }
         switch(choice) {
             case 1:
                 addItem(inventory);
                 break;
             case 2:
-                findItem(inventory);
+                findItem(fastStart);
                 break;
             case 3:
                 updateItem(inventory);
@@ -272,10 +384,10 @@ int main() {
                         break;
                     case 3:
                         cout << "\n--- Shopping Cart ---" << endl;
-                        cart.displayCart();
+                        cart.displayCart(inventory);
                         break;
                     case 4:
-                        cart.clearCart();
+                        cart.returnToInventory(inventory);
                         cout << "Cart cleared." << endl;
                         break;
                     case 5:
@@ -356,6 +468,12 @@ int main() {
                 }
                 break;
             }
+            case 8:
+                runSimulation(inventory);
+                break;
+            case 9:
+                browseItems(inventory);
+                break;
             case 0:
                 cout << "Exiting program. Goodbye!" << endl;
                 break;
@@ -364,5 +482,11 @@ int main() {
         }
     } while (choice != 0);
     
+    // Items left in the cart go back on the shelf before the final checkpoint
+    cart.returnToInventory(inventory);
+    if (inventoryLog.isOpen()) {
+        inventoryLog.checkpoint();
+    }
+    
     return 0;
 }
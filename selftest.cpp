@@ -0,0 +1,792 @@
+// selftest.cpp - Self-checks for the journals, logs and inventory structures
+// Part of CSC 307 Grocery Store Simulator project
+//
+//   selftest [CHECK...]   run the named checks (all of them if none given)
+//   selftest --list       list the checks
+//
+// Each check works in its own scratch directory under the system temp
+// directory. Exits with 1 if any check fails.
+
+#include <algorithm>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "AggregationKernels.h"
+#include "AVLTree.h"
+#include "CatalogLoader.h"
+#include "InventoryLog.h"
+#include "ShoppingCart.h"
+#include "TransactionJournal.h"
+#include "TransactionProcessing.h"
+#include "VersionedInventory.h"
+
+#if !defined(_WIN32)
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+namespace fs = std::filesystem;
+
+// Print what went wrong when condition does not hold
+bool expect(bool condition, const std::string& what) {
+    if (!condition) {
+        std::cout << "  failed: " << what << std::endl;
+    }
+    return condition;
+}
+
+// An empty scratch directory for one check
+fs::path scratch(const std::string& name) {
+    fs::path dir = fs::temp_directory_path() / "gss-selftest" / name;
+    std::error_code ec;
+    fs::remove_all(dir, ec);
+    fs::create_directories(dir);
+    return dir;
+}
+
+void writeBytes(const fs::path& path, const std::string& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+JournalReader::ScanResult scanAll(const std::string& path) {
+    return JournalReader::scan(path, [](const unsigned char*, size_t) { return true; });
+}
+
+// A journal that is empty or cut off inside its 8-byte header has no
+// valid prefix: the writer must lay down a fresh header, not pad the file
+// out to header length
+bool checkJournalShortFile() {
+    fs::path dir = scratch("journal-short");
+    bool ok = true;
+    const std::string cases[] = {std::string(), std::string("GSJ"), std::string("GSJ1\x02", 5)};
+    for (const std::string& start : cases) {
+        std::string path = (dir / "short.log").string();
+        writeBytes(path, start);
+        std::string label = std::to_string(start.size()) + "-byte journal";
+
+        JournalReader::ScanResult scan = scanAll(path);
+        ok &= expect(scan.opened && scan.headerValid, label + " reads as an empty journal");
+        ok &= expect(scan.validLength == 0, label + " has no valid prefix");
+
+        JournalWriter writer;
+        std::vector<unsigned char> record = {1, 2, 3};
+        ok &= expect(writer.open(path, scan.validLength) && writer.append(record) && writer.sync(),
+                     label + " reopens for writing");
+        writer.close();
+        JournalReader::ScanResult reread = scanAll(path);
+        ok &= expect(reread.headerValid && reread.records == 1 && !reread.truncatedTail,
+                     label + " holds the new record after reopening");
+    }
+
+    // The same through InventoryLog: an empty log left by a crash before
+    // the first record must not switch persistence off
+    std::string logFile = (dir / "inventory.log").string();
+    std::string checkpointFile = (dir / "inventory.ckpt").string();
+    writeBytes(logFile, std::string());
+    {
+        AVLTree inventory;
+        InventoryLog log(logFile, checkpointFile);
+        ok &= expect(log.open(inventory).opened, "inventory log opens over an empty file");
+        inventory.insert(GroceryItem("Milk", UpcKey::fromRaw(100001), Money::fromCents(399), 5, "Dairy"));
+    }
+    {
+        AVLTree inventory;
+        InventoryLog log(logFile, checkpointFile);
+        InventoryRecoveryResult result = log.open(inventory);
+        ok &= expect(result.opened && inventory.size() == 1, "change logged after an empty log is recovered");
+    }
+    return ok;
+}
+
+// Rows of a catalog CSV, including names with commas in them, a row
+// missing its name field and one with the field left empty, then the name
+// index through bulk load and edits
+bool checkCatalogLoad() {
+    fs::path dir = scratch("catalog-load");
+    std::string path = (dir / "catalog.csv").string();
+    writeBytes(path, "upc,name,price,quantity,aisle\n"
+                     "100004,Milk, 2%,3.49,10,Dairy\n"
+                     "100001,milk chocolate,1.99,25,Snacks\n"
+                     "100003,2.99,5,Dairy\n"
+                     "100007,,2.99,5,Dairy\n"
+                     "100002,Bread,2.49,8,Bakery\n"
+                     "100005,Mild Salsa,3.99,6,Pantry\n");
+    AVLTree inventory;
+    inventory.enableSecondaryIndexes();
+    CatalogLoadResult result = loadCatalog(path, inventory);
+    bool ok = true;
+    ok &= expect(result.opened && result.rows == 6 && result.loaded == 4 && result.malformed == 2,
+                 "four items load and the rows without a name are malformed");
+    ok &= expect(inventory.search(UpcKey::fromString("100003")) == nullptr &&
+                 inventory.search(UpcKey::fromString("100007")) == nullptr,
+                 "the rows without a name are not loaded");
+    const GroceryItem* milk = inventory.search(UpcKey::fromString("100004"));
+    ok &= expect(milk != nullptr && milk->getName() == "Milk, 2%" && milk->getPrice() == Money::fromCents(349),
+                 "a name may contain commas");
+
+    auto prefixed = [&inventory](std::string_view prefix) {
+        std::vector<std::string> upcs;
+        for (UpcKey upc : inventory.itemsWithNamePrefix(prefix)) upcs.push_back(upc.toString());
+        return upcs;
+    };
+    ok &= expect(prefixed("MIL") == std::vector<std::string>{"100005", "100001", "100004"},
+                 "name prefix after the bulk load, in name order");
+    inventory.insert(GroceryItem("Milkweed Honey", UpcKey::fromString("100006"), Money::fromCents(899), 2, "Pantry"));
+    inventory.remove(UpcKey::fromString("100005"));
+    GroceryItem renamed = *inventory.search(UpcKey::fromString("100001"));
+    renamed.setName("Dark Chocolate");
+    inventory.update(UpcKey::fromString("100001"), renamed);
+    ok &= expect(prefixed("milk") == std::vector<std::string>{"100004", "100006"},
+                 "name prefix follows inserts, removals and renames");
+    ok &= expect(prefixed("").size() == 4 && prefixed("x").empty(), "empty and unmatched prefixes");
+    return ok;
+}
+
+// After a clean shutdown the checkpoint answers lookups while recovery
+// runs; with changes in the log past it, only the recovered tree may
+bool checkFastStart() {
+    fs::path dir = scratch("fast-start");
+    std::string logFile = (dir / "inventory.log").string();
+    std::string checkpointFile = (dir / "inventory.ckpt").string();
+    UpcKey milk = UpcKey::fromString("100001");
+    bool ok = true;
+    {
+        AVLTree inventory;
+        InventoryLog log(logFile, checkpointFile);
+        ok &= expect(log.open(inventory).opened, "log opens");
+        for (int i = 0; i < 5000; ++i) {
+            inventory.insert(GroceryItem("Item " + std::to_string(i), UpcKey::fromString(std::to_string(100000 + i)),
+                                         Money::fromCents(100 + i), 10, "Pantry"));
+        }
+        ok &= expect(log.checkpoint(), "clean shutdown checkpoint");
+    }
+    GroceryItem item;
+    {
+        AVLTree inventory;
+        InventoryLog log(logFile, checkpointFile);
+        FastStartInventory fastStart(log, inventory);
+        ok &= expect(fastStart.start(), "checkpoint serves lookups after a clean shutdown");
+        ok &= expect(fastStart.lookup(milk, item) && item.getPrice() == Money::fromCents(101),
+                     "lookup answered while recovering");
+        ok &= expect(fastStart.wait().restored && inventory.size() == 5000, "recovery completes");
+        ok &= expect(fastStart.lookup(milk, item) && item.getQuantity() == 10, "lookup answered from the tree");
+        inventory.adjustStock(*inventory.search(milk), -3); // logged, not checkpointed
+    }
+    {
+        AVLTree inventory;
+        InventoryLog log(logFile, checkpointFile);
+        FastStartInventory fastStart(log, inventory);
+        ok &= expect(!fastStart.start(), "checkpoint is not used with changes logged past it");
+        fastStart.wait();
+        ok &= expect(fastStart.lookup(milk, item) && item.getQuantity() == 7, "lookup sees the replayed change");
+    }
+    return ok;
+}
+
+// splitmix64: a well-mixed 64-bit value from a counter
+uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Order-sensitive hash of every field of every item
+uint64_t inventoryDigest(const AVLTree& inventory) {
+    uint64_t digest = 1469598103934665603ull;
+    auto add = [&digest](uint64_t value) { digest = (digest ^ value) * 1099511628211ull; };
+    inventory.forEachItem([&](const GroceryItem& item) {
+        add(item.getUpc().raw());
+        add(static_cast<uint64_t>(item.getPrice().getCents()));
+        add(static_cast<uint64_t>(item.getQuantity()));
+        add(std::hash<std::string_view>()(item.getName()));
+        add(std::hash<std::string_view>()(item.getAisle()));
+    });
+    return digest;
+}
+
+// Step n of a deterministic workload over 400 UPCs: inserts, price
+// updates, removals and stock changes, the way the menu and carts make them
+void applyStep(AVLTree& inventory, uint64_t step) {
+    uint64_t r = mix(step);
+    UpcKey upc = UpcKey::fromRaw(300000 + r % 400);
+    GroceryItem* item = inventory.search(upc);
+    int amount = static_cast<int>((r >> 20) % 5) + 1;
+    switch ((r >> 12) % 8) {
+    case 0:
+    case 1:
+        if (item == nullptr) {
+            inventory.insert(GroceryItem("Item " + std::to_string(upc.raw()), upc,
+                                         Money::fromCents(static_cast<int64_t>(r >> 40) % 2000 + 50),
+                                         amount * 10, (r >> 30) % 2 ? "Dairy" : "Produce"));
+        } else {
+            GroceryItem changed = *item;
+            changed.setPrice(item->getPrice() + Money::fromCents(amount));
+            inventory.update(upc, changed);
+        }
+        break;
+    case 2:
+        inventory.remove(upc);
+        break;
+    default:
+        if (item != nullptr) {
+            inventory.adjustStock(*item, item->getQuantity() >= amount && r % 2 ? -amount : amount);
+        }
+        break;
+    }
+}
+
+// Changes logged since the last checkpoint must survive a restart, and
+// a checkpoint that cannot start a new log must leave logging running
+bool checkInventoryLogCheckpointFailure() {
+    fs::path dir = scratch("inventory-checkpoint-failure");
+    std::string logFile = (dir / "inventory.log").string();
+    std::string checkpointFile = (dir / "inventory.ckpt").string();
+    bool ok = true;
+    uint64_t expected;
+    {
+        AVLTree inventory;
+        InventoryLog log(logFile, checkpointFile);
+        ok &= expect(log.open(inventory).opened, "log opens");
+        for (uint64_t step = 1; step <= 200; ++step) applyStep(inventory, step);
+        ok &= expect(log.checkpoint(), "first checkpoint");
+        for (uint64_t step = 201; step <= 300; ++step) applyStep(inventory, step);
+
+        // A directory where the fresh log would be created makes the
+        // checkpoint fail after the writer has been stopped
+        fs::create_directory(logFile + ".tmp");
+        ok &= expect(!log.checkpoint(), "checkpoint reports the failure");
+        ok &= expect(log.isOpen(), "log stays open after the failed checkpoint");
+        for (uint64_t step = 301; step <= 400; ++step) applyStep(inventory, step);
+        expected = inventoryDigest(inventory);
+    }
+    {
+        AVLTree inventory;
+        InventoryLog log(logFile, checkpointFile);
+        InventoryRecoveryResult result = log.open(inventory);
+        ok &= expect(result.opened && inventoryDigest(inventory) == expected,
+                     "changes after the failed checkpoint are recovered");
+    }
+    return ok;
+}
+
+#if !defined(_WIN32)
+// Kill a process that is logging and checkpointing at random points and
+// recover in this one. With group commit the tail that was not yet synced
+// may be lost, so the recovered inventory must equal the workload's state
+// after some step at or beyond the last one the child saw flushed.
+bool checkInventoryLogCrashRecovery() {
+    const uint64_t kSteps = 20000;
+    const int kTrials = 40;
+    fs::path dir = scratch("inventory-crash");
+    std::string logFile = (dir / "inventory.log").string();
+    std::string checkpointFile = (dir / "inventory.ckpt").string();
+
+    std::vector<uint64_t> digests(kSteps + 1);
+    {
+        AVLTree reference;
+        digests[0] = inventoryDigest(reference);
+        for (uint64_t step = 1; step <= kSteps; ++step) {
+            applyStep(reference, step);
+            digests[step] = inventoryDigest(reference);
+        }
+    }
+
+    bool ok = true;
+    for (int trial = 0; trial < kTrials && ok; ++trial) {
+        fs::remove(logFile);
+        fs::remove(checkpointFile);
+        int acks[2];
+        if (pipe(acks) != 0) return expect(false, "pipe");
+        std::cout.flush();
+        pid_t child = fork();
+        if (child == 0) {
+            close(acks[0]);
+            InventoryLogOptions options;
+            options.checkpointEvery = 700;
+            AVLTree inventory;
+            InventoryLog log(logFile, checkpointFile, options);
+            if (!log.open(inventory).opened) _exit(3);
+            for (uint64_t step = 1; step <= kSteps; ++step) {
+                applyStep(inventory, step);
+                log.checkpointIfDue();
+                if (step % 64 == 0 && log.flush()) {
+                    if (write(acks[1], &step, sizeof step) != sizeof step) _exit(4);
+                }
+            }
+            _exit(0);
+        }
+        close(acks[1]);
+        usleep(static_cast<useconds_t>(mix(trial) % 40000));
+        kill(child, SIGKILL);
+        int status;
+        waitpid(child, &status, 0);
+        uint64_t acked = 0;
+        uint64_t step;
+        while (read(acks[0], &step, sizeof step) == sizeof step) acked = step;
+        close(acks[0]);
+
+        // Recover twice: the first recovery also repairs the files, and
+        // the second start must find them intact
+        std::string label = "trial " + std::to_string(trial) + ": ";
+        uint64_t digest = 0;
+        for (int restart = 0; restart < 2; ++restart) {
+            AVLTree inventory;
+            InventoryLog log(logFile, checkpointFile);
+            InventoryRecoveryResult result = log.open(inventory);
+            ok &= expect(result.opened, label + "log reopens on restart " + std::to_string(restart + 1));
+            if (restart == 1) {
+                ok &= expect(inventoryDigest(inventory) == digest, label + "second restart recovers the same state");
+                break;
+            }
+            digest = inventoryDigest(inventory);
+            bool matched = false;
+            for (uint64_t j = acked; j <= kSteps && !matched; ++j) {
+                matched = digests[j] == digest;
+            }
+            ok &= expect(matched, label + "recovered state is the workload after step " +
+                                  std::to_string(acked) + " or later");
+        }
+    }
+    return ok;
+}
+
+// Lanes record transactions from several threads under group commit and
+// ask for a flush now and then; the process is killed at a random point.
+// A flush that returned must never be undone: the journal has to come
+// back as an unbroken run of transactions reaching at least every ID a
+// lane saw flushed, and each lane's own records in the order it made them.
+bool checkGroupCommitCrashRecovery() {
+    const int kLanes = 4;
+    const int kTrials = 30;
+    const int kFirstId = 1000;
+    fs::path dir = scratch("group-commit-crash");
+    std::string logFile = (dir / "transactions.log").string();
+    GroceryItem item("Milk", UpcKey::fromString("100001"), Money::fromCents(399), 1, "Dairy");
+
+    bool ok = true;
+    for (int trial = 0; trial < kTrials && ok; ++trial) {
+        fs::remove(logFile);
+        int acks[2];
+        if (pipe(acks) != 0) return expect(false, "pipe");
+        std::cout.flush();
+        pid_t child = fork();
+        if (child == 0) {
+            close(acks[0]);
+            GroupCommitOptions durability;
+            durability.batchSize = 32;
+            durability.interval = std::chrono::milliseconds(1);
+            TransactionManager manager(logFile, "", durability);
+            std::mutex managerLock;
+            std::vector<std::thread> lanes;
+            for (int lane = 0; lane < kLanes; ++lane) {
+                lanes.emplace_back([&, lane] {
+                    InternedString name("Lane " + std::to_string(lane));
+                    for (int64_t seq = 0;; ++seq) {
+                        Money amount = Money::fromCents(lane * 1000000 + seq);
+                        int id;
+                        {
+                            std::lock_guard<std::mutex> guard(managerLock);
+                            id = manager.addTransaction(lane, name, {{item, 1}}, amount, Money(), Money(), amount);
+                        }
+                        if (seq % 16 == 15 && manager.flush()) {
+                            if (write(acks[1], &id, sizeof id) != sizeof id) _exit(4);
+                        }
+                    }
+                });
+            }
+            for (std::thread& lane : lanes) lane.join();
+            _exit(0);
+        }
+        close(acks[1]);
+        usleep(static_cast<useconds_t>(5000 + mix(trial) % 60000));
+        kill(child, SIGKILL);
+        int status;
+        waitpid(child, &status, 0);
+        int acked = 0;
+        int id;
+        while (read(acks[0], &id, sizeof id) == sizeof id) acked = std::max(acked, id);
+        close(acks[0]);
+
+        std::string label = "trial " + std::to_string(trial) + ": ";
+        size_t recovered;
+        {
+            TransactionManager manager(logFile, "");
+            const std::vector<Transaction>& history = manager.getAllTransactions();
+            recovered = history.size();
+            std::vector<int64_t> nextSeq(kLanes, 0);
+            bool intact = true;
+            for (size_t i = 0; i < history.size() && intact; ++i) {
+                const Transaction& t = history[i];
+                int lane = t.getCustomerId();
+                intact = t.getTransactionId() == kFirstId + static_cast<int>(i) && lane >= 0 && lane < kLanes &&
+                         t.getTotal() == Money::fromCents(lane * 1000000 + nextSeq[lane]++) &&
+                         t.getCustomerName() == "Lane " + std::to_string(lane);
+            }
+            ok &= expect(intact, label + "journal replays as an unbroken run in each lane's order");
+            ok &= expect(acked == 0 || (!history.empty() && history.back().getTransactionId() >= acked),
+                         label + "every flushed transaction up to " + std::to_string(acked) + " survives");
+            manager.addTransaction(-1, InternedString("Guest"), {{item, 1}}, item.getPrice(), Money(), Money(),
+                                   item.getPrice());
+        }
+        TransactionManager reopened(logFile, "");
+        ok &= expect(reopened.getTransactionCount() == recovered + 1,
+                     label + "a transaction added after recovery survives the next restart");
+    }
+    return ok;
+}
+#endif
+
+// Shoppers on several threads fill carts from a few scarce items, then
+// either pay or put everything back, while a stocker tops the shelves up.
+// No item may ever be oversold: units on the shelf plus units paid for
+// must equal the starting stock plus restocks, item by item. Negative
+// stock levels must be refused.
+bool checkConcurrentStock() {
+    const int kItems = 16;
+    const int kStock = 40;
+    const int kShoppers = 6;
+    const int kCartsPerShopper = 100000;
+    ConcurrentInventory inventory;
+    std::vector<UpcKey> upcs;
+    for (int i = 0; i < kItems; ++i) {
+        upcs.push_back(UpcKey::fromString(std::to_string(500000 + i)));
+        inventory.insert(GroceryItem("Item " + std::to_string(i), upcs.back(), Money::fromCents(250), kStock, "Pantry"));
+    }
+
+    std::vector<std::vector<int64_t>> sold(kShoppers, std::vector<int64_t>(kItems, 0));
+    std::atomic<size_t> badCounts(0);
+    // A stocker keeps topping the shelves up, so items hover around empty
+    // and shoppers keep racing for the last units
+    std::vector<int64_t> restocked(kItems, 0);
+    std::atomic<int> shopping(kShoppers);
+    std::thread stocker([&] {
+        for (uint64_t n = 0; shopping.load() > 0; ++n) {
+            int i = static_cast<int>(mix(n) % kItems);
+            GroceryItem item;
+            if (inventory.lookup(upcs[i], item) && inventory.release(item.getSku(), 2)) restocked[i] += 2;
+            std::this_thread::yield();
+        }
+    });
+    std::vector<std::thread> shoppers;
+    for (int s = 0; s < kShoppers; ++s) {
+        shoppers.emplace_back([&, s] {
+            ShoppingCart cart;
+            for (int n = 0; n < kCartsPerShopper; ++n) {
+                uint64_t r = mix(uint64_t(s) << 32 | uint64_t(n));
+                for (int pick = 0; pick < 3; ++pick) {
+                    cart.tryAddItem(inventory, upcs[(r >> (pick * 8)) % kItems], static_cast<int>((r >> 40) % 3) + 1);
+                }
+                bool pays = (r >> 50) % 4 == 0;
+                for (const CartLine& line : cart.getLines()) {
+                    if (pays) {
+                        sold[s][std::find(upcs.begin(), upcs.end(), line.upc) - upcs.begin()] += line.quantity;
+                    } else if (!inventory.release(line.sku, line.quantity)) {
+                        badCounts++;
+                    }
+                    if (inventory.stockLevel(line.sku) < 0) badCounts++;
+                }
+                cart.clearCart();
+            }
+            shopping--;
+        });
+    }
+    for (std::thread& shopper : shoppers) shopper.join();
+    stocker.join();
+
+    bool ok = expect(badCounts.load() == 0, "stock never reads negative and every return is accepted");
+    int64_t totalSold = 0;
+    for (int i = 0; i < kItems; ++i) {
+        GroceryItem item;
+        int64_t paidFor = 0;
+        for (int s = 0; s < kShoppers; ++s) paidFor += sold[s][i];
+        totalSold += paidFor;
+        ok &= expect(inventory.lookup(upcs[i], item) && item.getQuantity() + paidFor == kStock + restocked[i],
+                     "item " + std::to_string(i) + ": shelf plus sold equals starting stock plus restocks");
+    }
+    ok &= expect(totalSold > int64_t(kItems) * kStock, "shoppers bought more than the first delivery");
+
+    GroceryItem item;
+    inventory.lookup(upcs[0], item);
+    int before = item.getQuantity();
+    GroceryItem negative = item;
+    negative.setQuantity(-1);
+    ok &= expect(!inventory.update(upcs[0], negative), "update to a negative quantity is refused");
+    inventory.lookup(upcs[0], item);
+    ok &= expect(item.getQuantity() == before && inventory.tryReserve(item.getSku(), 0) == false &&
+                     (before == 0 || inventory.tryReserve(item.getSku(), 1)),
+                 "the refused update leaves the SKU trading");
+    UpcKey extra = UpcKey::fromString("500999");
+    inventory.insert(GroceryItem("Negative", extra, Money::fromCents(100), -5, "Pantry"));
+    ok &= expect(!inventory.lookup(extra, item), "an item with negative stock is not added");
+    return ok;
+}
+
+// Readers value snapshots while writers keep moving stock between items
+// and changing prices. Every move is one version, so each snapshot must
+// hold the starting number of units, walk to the totals it carries, and
+// give the same answer however often it is walked.
+bool checkSnapshotStability() {
+    const int kItems = 500;
+    const int kWriters = 3;
+    const int kReaders = 2;
+    const int kMovesPerWriter = 20000;
+    VersionedInventory inventory;
+    std::vector<GroceryItem> items;
+    for (int i = 0; i < kItems; ++i) {
+        items.emplace_back("Item " + std::to_string(i), UpcKey::fromRaw(400000 + i),
+                           Money::fromCents(100 + i), 50, "Pantry");
+    }
+    inventory.assignSorted(items);
+    const int64_t kUnits = int64_t(kItems) * 50;
+
+    InventorySnapshot first = inventory.snapshot();
+    const Money firstValue = first.totalValue();
+
+    auto walk = [](const InventorySnapshot& view, int64_t& units, Money& value) {
+        units = 0;
+        value = Money();
+        view.forEachItem([&](const GroceryItem& item) {
+            units += item.getQuantity();
+            value += item.getPrice() * item.getQuantity();
+        });
+    };
+
+    std::atomic<int> writersLeft(kWriters);
+    std::atomic<size_t> failures(0);
+    std::atomic<size_t> snapshots(0);
+    std::vector<std::thread> threads;
+    for (int w = 0; w < kWriters; ++w) {
+        threads.emplace_back([&, w] {
+            for (int n = 0; n < kMovesPerWriter; ++n) {
+                uint64_t r = mix(uint64_t(w) << 32 | uint64_t(n));
+                UpcKey from = UpcKey::fromRaw(400000 + r % kItems);
+                UpcKey to = UpcKey::fromRaw(400000 + (r >> 16) % kItems);
+                int amount = static_cast<int>((r >> 32) % 4) + 1;
+                inventory.apply([&](InventoryEditor& e) {
+                    if ((r >> 40) % 8 == 0) {
+                        GroceryItem item = *e.find(to);
+                        item.setPrice(Money::fromCents(static_cast<int64_t>(r >> 48) % 900 + 100));
+                        return e.update(to, item);
+                    }
+                    GroceryItem seen;
+                    return e.reserveStock(from, amount, seen) == StockStatus::Ok &&
+                           e.releaseStock(to, amount) == StockStatus::Ok;
+                });
+            }
+            writersLeft--;
+        });
+    }
+    for (int r = 0; r < kReaders; ++r) {
+        threads.emplace_back([&] {
+            uint64_t lastVersion = 0;
+            do {
+                InventorySnapshot view = inventory.snapshot();
+                int64_t units, unitsAgain;
+                Money value, valueAgain;
+                walk(view, units, value);
+                std::this_thread::yield();
+                walk(view, unitsAgain, valueAgain);
+                if (view.version() < lastVersion || view.size() != size_t(kItems) || units != kUnits ||
+                    view.totalUnits() != kUnits || value != view.totalValue() || unitsAgain != units ||
+                    valueAgain != value) {
+                    failures++;
+                }
+                lastVersion = view.version();
+                snapshots++;
+            } while (writersLeft.load() > 0);
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+
+    bool ok = true;
+    ok &= expect(failures.load() == 0, std::to_string(failures.load()) + " of " +
+                                           std::to_string(snapshots.load()) + " snapshots changed or did not add up");
+    int64_t units;
+    Money value;
+    walk(first, units, value);
+    ok &= expect(units == kUnits && value == firstValue && first.version() == 1,
+                 "a snapshot held through every change still shows its own version");
+    InventorySnapshot last = inventory.snapshot();
+    walk(last, units, value);
+    ok &= expect(units == kUnits && value == last.totalValue() && last.version() > first.version(),
+                 "the final version adds up");
+    return ok;
+}
+
+// The running revenue figures must match a from-scratch recount of the
+// rows after an import, after new sales and after a reload
+bool checkSalesAggregates() {
+    fs::path dir = scratch("sales-aggregates");
+    std::string logPath = (dir / "transactions.log").string();
+    std::string csvPath = (dir / "transactions.csv").string();
+    // Days out of order, a day split across the file, and a timestamp
+    // that does not parse
+    writeBytes(csvPath,
+               "1,7,Ann,10.00,0.00,0.80,10.80,2024-03-01 09:00:00,100001,2,5.00\n"
+               "2,-1,Guest,4.00,0.50,0.28,3.78,2024-02-29 18:30:00,100002,1,4.00\n"
+               "3,7,Ann,6.00,0.00,0.48,6.48,2024-03-01 23:59:59,100001,1,5.00;100003,1,1.00\n"
+               "4,9,Bo,3.00,0.00,0.24,3.24,someday,100003,3,1.00\n"
+               "5,-1,Guest,12.00,0.00,0.96,12.96,2023-12-31 23:59:59,100002,3,4.00\n");
+
+    bool ok = true;
+    GroceryItem item("Tea", UpcKey::fromRaw(100004), Money::fromCents(250), 10, "Pantry");
+    {
+        TransactionManager manager(logPath, csvPath);
+        ok &= expect(manager.getTransactionCount() == 5, "the CSV history is imported");
+        ok &= expect(manager.verifyAggregates(), "aggregates match the rows after the import");
+        ok &= expect(manager.getDailyRevenue("2024-03-01") == Money::fromCents(1728),
+                     "a day split across the file is summed");
+        ok &= expect(manager.getRevenueBetween("2024-03-01", "2024-03-02") == Money::fromCents(1728),
+                     "the masked-sum kernel gives the same day");
+        ok &= expect(manager.getTotalRevenue() == Money::fromCents(3726), "total revenue after the import");
+        for (int i = 0; i < 50; ++i) {
+            manager.addTransaction(i % 3, InternedString("Customer " + std::to_string(i % 3)), {{item, 1 + i % 4}},
+                                   Money::fromCents(250), Money(), Money::fromCents(20), Money::fromCents(270 + i));
+        }
+        ok &= expect(manager.verifyAggregates(), "aggregates match the rows after new sales");
+        ok &= expect(manager.flush(), "new sales reach the journal");
+    }
+    TransactionManager reopened(logPath, csvPath);
+    ok &= expect(reopened.getTransactionCount() == 55, "the journal holds every sale");
+    ok &= expect(reopened.verifyAggregates(), "aggregates match the rows after a reload");
+    reopened.useApproximateTopSellers(64 * 1024, 10);
+    ok &= expect(reopened.verifyAggregates(), "aggregates match the rows with approximate best sellers");
+    return ok;
+}
+
+// The AVX2 kernels must give exactly what the scalar ones give, on
+// lengths that leave every possible tail and on ranges that cover none,
+// some or all of the rows, in time order or not
+bool checkAggregationKernels() {
+    std::vector<int64_t> values(1000);
+    std::vector<int64_t> times(values.size());
+    uint64_t state = 42;
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<int64_t>(mix(state++) % 2000001) - 1000000;
+        times[i] = static_cast<int64_t>(i) * 10;
+    }
+    std::vector<int64_t> shuffled = times;
+    for (size_t i = shuffled.size() - 1; i > 0; --i) std::swap(shuffled[i], shuffled[mix(state++) % (i + 1)]);
+
+    const int64_t ranges[][2] = {{-50, -1}, {0, 10000}, {2000, 2040}, {5, 6}, {4995, 7005}, {9990, 20000}};
+    bool ok = true;
+    for (size_t count : {size_t(0), size_t(1), size_t(3), size_t(4), size_t(7), size_t(8), size_t(15),
+                         size_t(16), size_t(17), size_t(999), size_t(1000)}) {
+        int64_t sums[2], ranged[2][2][6], lows[2] = {0, 0}, highs[2] = {0, 0};
+        bool found[2];
+        for (int scalar = 0; scalar < 2; ++scalar) {
+            useScalarKernels(scalar == 1);
+            sums[scalar] = sumColumn(values.data(), count);
+            for (int order = 0; order < 2; ++order) {
+                const int64_t* t = order == 0 ? times.data() : shuffled.data();
+                for (size_t r = 0; r < 6; ++r) {
+                    ranged[scalar][order][r] = sumInTimeRange(values.data(), t, count, ranges[r][0], ranges[r][1]);
+                }
+            }
+            found[scalar] = minMaxColumn(values.data(), count, lows[scalar], highs[scalar]);
+        }
+        useScalarKernels(false);
+        std::string label = std::to_string(count) + " rows";
+        ok &= expect(sums[0] == sums[1], label + ": sums agree");
+        ok &= expect(std::memcmp(ranged[0], ranged[1], sizeof ranged[0]) == 0, label + ": time-range sums agree");
+        ok &= expect(found[0] == found[1] && found[0] == (count > 0) && lows[0] == lows[1] && highs[0] == highs[1],
+                     label + ": min/max agree");
+    }
+    return ok;
+}
+
+// addItems combines repeated scans of a UPC before checking stock; a
+// combined quantity past INT_MAX must be rejected, not wrap negative and
+// hand stock back
+bool checkBatchScan() {
+    AVLTree inventory;
+    UpcKey tea = UpcKey::fromRaw(100001), milk = UpcKey::fromRaw(100002), missing = UpcKey::fromRaw(100003);
+    inventory.insert(GroceryItem("Tea", tea, Money::fromCents(250), INT_MAX, "Pantry"));
+    inventory.insert(GroceryItem("Milk", milk, Money::fromCents(349), 5, "Dairy"));
+    ShoppingCart cart;
+
+    const std::pair<UpcKey, int> scans[] = {{tea, INT_MAX}, {milk, 2}, {tea, 2}, {missing, 1}, {milk, 3}, {milk, 0}};
+    BatchScanResult result = cart.addItems(inventory, scans, 6);
+    const StockStatus expected[] = {StockStatus::InvalidQuantity, StockStatus::Ok, StockStatus::InvalidQuantity,
+                                    StockStatus::NotFound, StockStatus::Ok, StockStatus::InvalidQuantity};
+    bool ok = expect(std::equal(result.status.begin(), result.status.end(), expected), "every scan gets its status");
+    ok &= expect(result.accepted == 2 && result.unitsAdded == 5, "only the milk scans are accepted");
+    ok &= expect(inventory.search(tea)->getQuantity() == INT_MAX && cart.quantityOf(tea) == 0,
+                 "an overflowing total leaves the stock and the cart alone");
+    ok &= expect(inventory.search(milk)->getQuantity() == 0 && cart.quantityOf(milk) == 5,
+                 "repeated scans are taken as one quantity");
+
+    const std::pair<UpcKey, int> more[] = {{milk, 1}};
+    result = cart.addItems(inventory, more, 1);
+    ok &= expect(result.status[0] == StockStatus::InsufficientStock && cart.quantityOf(milk) == 5,
+                 "a sold-out item is refused");
+    return ok;
+}
+
+struct Check {
+    const char* name;
+    bool (*run)();
+};
+
+const Check kChecks[] = {
+    {"journal-short", checkJournalShortFile},
+    {"catalog-load", checkCatalogLoad},
+    {"inventory-checkpoint-failure", checkInventoryLogCheckpointFailure},
+    {"fast-start", checkFastStart},
+    {"concurrent-stock", checkConcurrentStock},
+    {"snapshot-stability", checkSnapshotStability},
+    {"sales-aggregates", checkSalesAggregates},
+    {"aggregation-kernels", checkAggregationKernels},
+    {"batch-scan", checkBatchScan},
+#if !defined(_WIN32)
+    {"inventory-crash", checkInventoryLogCrashRecovery},
+    {"group-commit-crash", checkGroupCommitCrashRecovery},
+#endif
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<const Check*> selected;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--list") == 0) {
+            for (const Check& check : kChecks) std::cout << check.name << std::endl;
+            return 0;
+        }
+        const Check* found = nullptr;
+        for (const Check& check : kChecks) {
+            if (std::strcmp(argv[i], check.name) == 0) found = &check;
+        }
+        if (found == nullptr) {
+            std::cerr << "Unknown check " << argv[i] << std::endl;
+            return 2;
+        }
+        selected.push_back(found);
+    }
+    if (selected.empty()) {
+        for (const Check& check : kChecks) selected.push_back(&check);
+    }
+
+    size_t failed = 0;
+    for (const Check* check : selected) {
+        std::cout << check->name << "..." << std::endl;
+        bool passed = check->run();
+        std::cout << (passed ? "  ok" : "  FAILED") << std::endl;
+        failed += passed ? 0 : 1;
+    }
+    std::cout << selected.size() - failed << "/" << selected.size() << " checks passed" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
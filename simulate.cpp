@@ -0,0 +1,142 @@
+// simulate.cpp - Command-line driver for the discrete-event store model
+// Part of CSC 307 Grocery Store Simulator project
+//
+//   simulate [--days D] [--hours H] [--rate ARRIVALS_PER_HOUR] [--lanes L]
+//            [--items N] [--basket MEAN] [--seed S] [--log FILE]
+//            [--check] [--bench]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include "AVLTree.h"
+#include "EventCalendar.h"
+#include "EventSimulation.h"
+#include "TransactionProcessing.h"
+
+namespace {
+
+const char* const kAisles[] = {"Produce", "Dairy", "Bakery", "Meat", "Frozen", "Pantry", "Snacks", "Household"};
+
+// A synthetic catalog of count items with UPCs 200000, 200001, ...
+void buildCatalog(AVLTree& inventory, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        UpcKey upc = UpcKey::fromString(std::to_string(200000 + i));
+        Money price = Money::fromCents(99 + static_cast<int64_t>(i * 37 % 1900));
+        inventory.insert(GroceryItem("Item " + std::to_string(i), upc, price, 150,
+                                     kAisles[i % (sizeof(kAisles) / sizeof(kAisles[0]))]));
+    }
+}
+
+// One run on a fresh catalog and a fresh journal
+EventSimReport runOnce(const EventSimConfig& config, size_t items, const std::string& logFile) {
+    std::error_code ec;
+    std::filesystem::remove(logFile, ec);
+    AVLTree inventory;
+    buildCatalog(inventory, items);
+    GroupCommitOptions durability;
+    durability.policy = DurabilityPolicy::Async;
+    TransactionManager transactions(logFile, "", durability);
+    return runEventSimulation(inventory, transactions, config);
+}
+
+void printReport(const EventSimReport& report) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "Customers: " << report.customers << ", checkouts: " << report.checkouts
+              << ", revenue: $" << report.revenue << std::endl;
+    std::cout << "Out-of-stock picks: " << report.rejectedPicks << ", restocks: " << report.restocks << std::endl;
+    std::cout << "Simulated: " << report.simulatedHours << " h, mean lane wait: "
+              << report.meanWaitMinutes << " min, longest line: " << report.maxQueue << std::endl;
+    std::cout << "Events: " << report.events << " in " << report.wallSeconds << " s ("
+              << std::setprecision(0) << report.eventsPerSecond << " events/s)" << std::endl;
+    std::cout << "Digest: " << std::hex << report.digest << std::dec << std::endl;
+}
+
+// Same seed twice must match exactly; a different seed must not
+bool checkReproducible(EventSimConfig config, size_t items, const std::string& logFile) {
+    EventSimReport first = runOnce(config, items, logFile);
+    EventSimReport second = runOnce(config, items, logFile);
+    config.seed++;
+    EventSimReport other = runOnce(config, items, logFile);
+
+    bool same = first.digest == second.digest && first.events == second.events &&
+                first.revenue == second.revenue && first.checkouts == second.checkouts;
+    bool differs = other.digest != first.digest;
+    std::cout << "Same seed reproduces: " << (same ? "yes" : "NO") << std::endl;
+    std::cout << "Different seed diverges: " << (differs ? "yes" : "NO") << std::endl;
+    return same && differs;
+}
+
+// The calendar alone under the classic hold model: pop the earliest
+// event and schedule one a random time later, with a steady population
+void benchCalendar(size_t population, size_t operations) {
+    EventCalendar calendar;
+    calendar.reserve(population);
+    std::mt19937_64 rng(1);
+    for (size_t i = 0; i < population; ++i) {
+        calendar.schedule(static_cast<int64_t>(rng() % 1000000), 0, static_cast<uint32_t>(i));
+    }
+    auto started = std::chrono::steady_clock::now();
+    uint64_t check = 0;
+    for (size_t i = 0; i < operations; ++i) {
+        SimEvent event = calendar.pop();
+        check += event.subject;
+        calendar.schedule(event.time + static_cast<int64_t>(rng() % 1000000), 0, event.subject);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+    std::cout << "Calendar hold model, " << population << " pending: " << std::fixed << std::setprecision(0)
+              << operations / seconds << " events/s (check " << check % 10 << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    EventSimConfig config;
+    double days = 1.0;
+    size_t items = 5000;
+    std::string logFile = "simulation_events.log";
+    bool check = false;
+    bool bench = false;
+
+    for (int i = 1; i < argc; ++i) {
+        auto value = [&](const char* flag) -> const char* {
+            if (std::strcmp(argv[i], flag) != 0) return nullptr;
+            if (i + 1 >= argc) {
+                std::cerr << flag << " needs a value" << std::endl;
+                std::exit(2);
+            }
+            return argv[++i];
+        };
+        const char* v;
+        if ((v = value("--days"))) days = std::atof(v);
+        else if ((v = value("--hours"))) config.hours = std::atof(v);
+        else if ((v = value("--rate"))) config.arrivalsPerHour = std::atof(v);
+        else if ((v = value("--lanes"))) config.lanes = std::strtoul(v, nullptr, 10);
+        else if ((v = value("--items"))) items = std::strtoul(v, nullptr, 10);
+        else if ((v = value("--basket"))) config.meanBasketSize = std::strtoul(v, nullptr, 10);
+        else if ((v = value("--seed"))) config.seed = std::strtoull(v, nullptr, 10);
+        else if ((v = value("--log"))) logFile = v;
+        else if (std::strcmp(argv[i], "--check") == 0) check = true;
+        else if (std::strcmp(argv[i], "--bench") == 0) bench = true;
+        else {
+            std::cerr << "Unknown option " << argv[i] << std::endl;
+            return 2;
+        }
+    }
+    // Days are back-to-back opening hours; the store never restocks overnight
+    config.hours *= days;
+
+    if (check) {
+        return checkReproducible(config, items, logFile) ? 0 : 1;
+    }
+    if (bench) {
+        benchCalendar(1000, 20000000);
+        benchCalendar(100000, 20000000);
+    }
+    printReport(runOnce(config, items, logFile));
+    return 0;
+}